@@ -0,0 +1,110 @@
+#include "Bench.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Counting replacements for the global allocation functions, so every stage
+// can report how many heap allocations it made and its peak live heap. Each
+// block carries its size just in front of the returned pointer.
+
+namespace {
+    constexpr std::size_t HeaderSize = alignof(std::max_align_t);
+
+    std::atomic<std::uint64_t> s_allocCount{0};
+    std::atomic<std::uint64_t> s_allocBytes{0};
+    std::atomic<std::int64_t> s_liveBytes{0};
+    std::atomic<std::int64_t> s_peakBytes{0};
+
+    void* track(char* raw, std::size_t header, std::size_t size) {
+        char* ptr = raw + header;
+        *reinterpret_cast<std::size_t*>(ptr - sizeof(std::size_t)) = size;
+
+        s_allocCount.fetch_add(1, std::memory_order_relaxed);
+        s_allocBytes.fetch_add(size, std::memory_order_relaxed);
+        auto live = s_liveBytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed) + static_cast<std::int64_t>(size);
+        auto peak = s_peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !s_peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        return ptr;
+    }
+
+    void untrack(void* ptr) {
+        auto size = *reinterpret_cast<std::size_t*>(static_cast<char*>(ptr) - sizeof(std::size_t));
+        s_liveBytes.fetch_sub(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+    }
+
+    void* countedAlloc(std::size_t size) {
+        if (auto raw = static_cast<char*>(std::malloc(size + HeaderSize))) {
+            return track(raw, HeaderSize, size);
+        }
+        throw std::bad_alloc();
+    }
+
+    void countedFree(void* ptr) {
+        if (!ptr) return;
+        untrack(ptr);
+        std::free(static_cast<char*>(ptr) - HeaderSize);
+    }
+
+    std::size_t alignedHeader(std::align_val_t align) {
+        auto alignment = static_cast<std::size_t>(align);
+        return alignment > HeaderSize ? alignment : HeaderSize;
+    }
+
+    void* countedAlignedAlloc(std::size_t size, std::align_val_t align) {
+        auto header = alignedHeader(align);
+        auto total = (size + header + header - 1) / header * header;
+#ifdef _WIN32
+        auto raw = static_cast<char*>(_aligned_malloc(total, header));
+#else
+        auto raw = static_cast<char*>(std::aligned_alloc(header, total));
+#endif
+        if (raw) {
+            return track(raw, header, size);
+        }
+        throw std::bad_alloc();
+    }
+
+    void countedAlignedFree(void* ptr, std::align_val_t align) {
+        if (!ptr) return;
+        untrack(ptr);
+        auto raw = static_cast<char*>(ptr) - alignedHeader(align);
+#ifdef _WIN32
+        _aligned_free(raw);
+#else
+        std::free(raw);
+#endif
+    }
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void operator delete(void* ptr) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t align) noexcept { countedAlignedFree(ptr, align); }
+void operator delete[](void* ptr, std::align_val_t align) noexcept { countedAlignedFree(ptr, align); }
+void operator delete(void* ptr, std::size_t, std::align_val_t align) noexcept { countedAlignedFree(ptr, align); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t align) noexcept { countedAlignedFree(ptr, align); }
+
+namespace bench {
+
+AllocStats allocStats() {
+    return {
+        s_allocCount.load(std::memory_order_relaxed),
+        s_allocBytes.load(std::memory_order_relaxed),
+        s_liveBytes.load(std::memory_order_relaxed),
+        s_peakBytes.load(std::memory_order_relaxed)
+    };
+}
+
+void resetPeak() {
+    s_peakBytes.store(s_liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+}
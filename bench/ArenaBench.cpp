@@ -0,0 +1,58 @@
+#include "Bench.hpp"
+#include "core/FontMetrics.hpp"
+#include "core/NewsLayout.hpp"
+#include "core/NewsParser.hpp"
+#include "core/ScratchArena.hpp"
+#include <cstdio>
+#include <string>
+
+namespace bench {
+
+namespace {
+    constexpr float CellWidth = 419.0f;
+    constexpr float PixelsPerPoint = 4.0f;
+
+    steamfeed::NewsLayoutStyle cellStyle(const steamfeed::FontMetrics& metrics) {
+        steamfeed::LayoutFont font;
+        font.lineHeight = static_cast<float>(metrics.lineHeight()) / PixelsPerPoint;
+        font.measure = [&metrics](std::string_view word) { return metrics.measure(word) / PixelsPerPoint; };
+        font.scale = 0.8f;
+        return { CellWidth, 40, font, font, font };
+    }
+}
+
+// Refresh after refresh the way the worker does them: the response parsed in place, deduped,
+// sanitized and laid out. Working tables on the heap against a ScratchArena kept between
+// refreshes, the heap columns are those of the last refresh, once the arena has grown.
+void runArenaBench(const Options& options, const std::vector<Payload>& payloads) {
+    steamfeed::FontMetrics metrics;
+    metrics.parse(syntheticFnt());
+    auto style = cellStyle(metrics);
+
+    for (const auto& payload : payloads) {
+        reportHeader("arena: " + payload.name + ", " + std::to_string(payload.body.size() / 1024) + " KB response");
+
+        for (bool useArena : { false, true }) {
+            steamfeed::ScratchArena arena;
+            std::vector<std::string> responses(options.iterations, payload.body);
+            std::size_t next = 0;
+            std::size_t items = 0;
+            auto result = measure(options.iterations, [&] {
+                steamfeed::ParsedFeed feed;
+                steamfeed::NewsLayout layout(style);
+                feed.parse(std::move(responses[next++]), gidRules(), [&](const steamfeed::NewsItemView& item) {
+                    layout.append(item.title, item.content);
+                    return true;
+                }, useArena ? &arena : nullptr);
+                items = feed.size();
+            });
+            report(useArena ? "arena" : "heap", result, payload.body.size(), items);
+            if (useArena) {
+                std::printf("%-16s %zu KB block, %zu KB past it on the last refresh\n", "",
+                    arena.capacity() / 1024, arena.overflow() / 1024);
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "core/GidRules.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+struct Options {
+    std::vector<std::string> payloadFiles;
+    std::vector<std::string> fontFiles; // .fnt metrics for the fonts and layout scenarios
+    std::size_t itemCount = 300;
+    int iterations = 20;
+};
+
+struct Payload {
+    std::string name;
+    std::string body;
+};
+
+// The recorded GetNewsForApp payloads given on the command line, or a synthetic
+// feed of options.itemCount articles when none were given
+std::vector<Payload> loadPayloads(const Options& options);
+
+// The rule table from the repo's assets/gid_rules.json, loaded on first use
+const steamfeed::GidRuleTable& gidRules();
+
+// A goldFont-like .fnt for when no real metrics file is given: printable ASCII with
+// uneven advances and a handful of kerning pairs
+std::string syntheticFnt();
+
+// Process-wide heap counters, fed by the operator new overrides in AllocCounter.cpp
+struct AllocStats {
+    std::uint64_t count = 0;
+    std::uint64_t bytes = 0;
+    std::int64_t liveBytes = 0;
+    std::int64_t peakBytes = 0;
+};
+AllocStats allocStats();
+// Restarts the peak tracking from the current live heap
+void resetPeak();
+
+// rapidjson base allocator that goes through operator new, so DOM memory shows up in the
+// counters. The core reader's own parse stack still uses rapidjson's malloc based default,
+// which is one buffer per parse rather than per item.
+class CountedCrtAllocator {
+public:
+    static const bool kNeedFree = true;
+
+    void* Malloc(std::size_t size) {
+        return size ? ::operator new(size) : nullptr;
+    }
+    void* Realloc(void* originalPtr, std::size_t originalSize, std::size_t newSize) {
+        if (newSize == 0) {
+            Free(originalPtr);
+            return nullptr;
+        }
+        void* ptr = ::operator new(newSize);
+        if (originalPtr) {
+            std::memcpy(ptr, originalPtr, std::min(originalSize, newSize));
+            Free(originalPtr);
+        }
+        return ptr;
+    }
+    static void Free(void* ptr) noexcept {
+        ::operator delete(ptr);
+    }
+
+    bool operator==(const CountedCrtAllocator&) const noexcept { return true; }
+    bool operator!=(const CountedCrtAllocator&) const noexcept { return false; }
+};
+
+struct StageResult {
+    double seconds = 0;       // best iteration
+    std::uint64_t allocs = 0; // per iteration
+    std::uint64_t allocBytes = 0;
+    std::int64_t peakBytes = 0; // live heap growth at the high-water mark
+};
+
+// Runs fn the given number of times, keeping the fastest run and the heap traffic of one run
+template <class F>
+StageResult measure(int iterations, F&& fn) {
+    StageResult result;
+    result.seconds = 1e30;
+    for (int i = 0; i < iterations; i++) {
+        resetPeak();
+        auto before = allocStats();
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        auto after = allocStats();
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        if (seconds < result.seconds) {
+            result.seconds = seconds;
+        }
+        result.allocs = after.count - before.count;
+        result.allocBytes = after.bytes - before.bytes;
+        result.peakBytes = after.peakBytes - before.liveBytes;
+    }
+    return result;
+}
+
+// Fails the run, main exits non-zero once every scenario is through. The check that fails
+// prints what went wrong itself.
+void markFailed();
+
+// One line of the stage table: time, MB/s over bytes, items/s, heap traffic per item and peak heap
+void report(const char* stage, const StageResult& result, std::size_t bytes, std::size_t items);
+void reportHeader(const std::string& title);
+
+}
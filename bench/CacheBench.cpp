@@ -0,0 +1,153 @@
+#include "Bench.hpp"
+#include "SyntheticFeed.hpp"
+#include "core/NewsApi.hpp"
+#include "core/NewsCache.hpp"
+#include "core/NewsParser.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace bench {
+
+namespace {
+    // roughly what fits on screen before any scrolling
+    constexpr std::size_t ScreenfulItems = 6;
+
+    std::string readFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    // reads every byte of the article, like laying it out would
+    std::size_t touch(const steamfeed::NewsItemView& item) {
+        std::size_t bytes = 0;
+        for (auto text : { item.title, item.content, item.date }) {
+            for (char c : text) {
+                bytes += c != '\0';
+            }
+        }
+        return bytes;
+    }
+
+    // what the first frame reads: the newest articles, which sit at the end in layer order
+    std::size_t touchFirstScreen(const steamfeed::NewsCache& cache) {
+        std::size_t bytes = 0;
+        for (std::size_t i = 0; i < ScreenfulItems && i < cache.size(); i++) {
+            bytes += touch(cache[cache.size() - 1 - i]);
+        }
+        return bytes;
+    }
+}
+
+// What opening the layer costs before anything is drawn. "cold" reads the response from a
+// local file standing in for the API and parses it, "warm" maps the cache and reads the
+// first screenful, "warm-all" reads every article. "refresh" is the conditional update that
+// merges a small page into the cache.
+void runCacheBench(const Options& options, const std::vector<Payload>& payloads) {
+    auto dir = std::filesystem::temp_directory_path() / "steamfeed_bench";
+    std::filesystem::create_directories(dir);
+    auto apiPath = dir / "api_response.json";
+    auto cachePath = dir / "news_cache.bin";
+
+    for (const auto& payload : payloads) {
+        reportHeader("cache: " + payload.name);
+        {
+            std::ofstream file(apiPath, std::ios::binary | std::ios::trunc);
+            file << payload.body;
+        }
+
+        std::vector<steamfeed::NewsItem> items;
+        auto cold = measure(options.iterations, [&] {
+            items = steamfeed::parseNewsItems(readFile(apiPath), gidRules());
+        });
+        report("cold", cold, payload.body.size(), items.size());
+
+        steamfeed::NewsCache writer;
+        writer.open(cachePath);
+        if (!writer.store(steamfeed::viewsOf(items))) {
+            std::printf("FAILED: could not write %s\n", cachePath.string().c_str());
+            markFailed();
+            continue;
+        }
+        auto cacheSize = static_cast<std::size_t>(std::filesystem::file_size(cachePath));
+
+        std::size_t cachedCount = 0;
+        std::size_t touched = 0;
+        auto warm = measure(options.iterations, [&] {
+            steamfeed::NewsCache cache;
+            cache.open(cachePath);
+            cachedCount = cache.size();
+            touched = touchFirstScreen(cache);
+        });
+        report("warm", warm, touched, std::min(cachedCount, ScreenfulItems));
+
+        auto warmAll = measure(options.iterations, [&] {
+            steamfeed::NewsCache cache;
+            cache.open(cachePath);
+            touched = 0;
+            for (const auto& item : cache.items()) {
+                touched += touch(item);
+            }
+        });
+        report("warm-all", warmAll, cacheSize, cachedCount);
+
+        if (cachedCount != items.size()) {
+            std::printf("MISMATCH: cache round trip lost articles\n");
+            markFailed();
+        }
+
+        // the feed shows articles straight out of the mapping, a store replacing the file has to
+        // leave them be for as long as the feed holds on to it
+        steamfeed::NewsCache shownCache;
+        shownCache.open(cachePath);
+        auto owner = shownCache.owner();
+        auto shown = shownCache.items();
+        std::vector<steamfeed::NewsItemView> newest(shown.begin(), shown.begin() + std::min<std::size_t>(shown.size(), ScreenfulItems));
+        if (shownCache.store(newest)) {
+            for (std::size_t i = 0; i < shown.size(); i++) {
+                if (shown[i].gid != items[i].gid || shown[i].content != items[i].content) {
+                    std::printf("MISMATCH: articles held past a store changed under the feed\n");
+                    markFailed();
+                    break;
+                }
+            }
+        }
+    }
+
+    // a refresh page from the same synthetic history, so it overlaps the cache
+    auto page = makeSyntheticFeed(steamfeed::RefreshPageCount);
+    auto history = steamfeed::parseNewsItems(makeSyntheticFeed(options.itemCount), gidRules());
+    auto historyViews = steamfeed::viewsOf(history);
+    auto refresh = measure(options.iterations, [&] {
+        auto merged = historyViews;
+        auto fresh = steamfeed::parseNewsItems(page, gidRules());
+        if (!steamfeed::mergeNewerItems(merged, steamfeed::viewsOf(fresh))) {
+            std::printf("FAILED: refresh page did not overlap the cache\n");
+            markFailed();
+        }
+    });
+    reportHeader("cache: conditional refresh");
+    report("refresh", refresh, page.size(), steamfeed::RefreshPageCount);
+
+    // a cache three articles behind the page: the merge has to say which of the page's articles it took
+    auto fresh = steamfeed::viewsOf(steamfeed::parseNewsItems(page, gidRules()));
+    std::vector<steamfeed::NewsItemView> behind(historyViews.begin() + 3, historyViews.end());
+    std::vector<std::size_t> taken;
+    if (!steamfeed::mergeNewerItems(behind, fresh, &taken) || taken.size() != 3
+        || behind.size() != historyViews.size()) {
+        std::printf("FAILED: merging a refresh into a cache behind it\n");
+        markFailed();
+    }
+    for (std::size_t i = 0; i < taken.size(); i++) {
+        if (taken[i] >= fresh.size() || behind[i].gid != fresh[taken[i]].gid) {
+            std::printf("FAILED: the merge's indices don't point at the articles it took\n");
+            markFailed();
+            break;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+}
@@ -0,0 +1,98 @@
+#include "Bench.hpp"
+#include "NewsStub.hpp"
+#include "core/FontMetrics.hpp"
+#include "core/HttpValidators.hpp"
+#include "core/NewsApi.hpp"
+#include "core/NewsLayout.hpp"
+#include "core/NewsParser.hpp"
+#include <chrono>
+#include <cstdio>
+
+namespace bench {
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Refreshes = 20;
+    constexpr float CellWidth = 419.0f;
+    constexpr float PixelsPerPoint = 4.0f;
+
+    steamfeed::NewsLayoutStyle cellStyle(const steamfeed::FontMetrics& metrics) {
+        steamfeed::LayoutFont font;
+        font.lineHeight = static_cast<float>(metrics.lineHeight()) / PixelsPerPoint;
+        font.measure = [&metrics](std::string_view word) { return metrics.measure(word) / PixelsPerPoint; };
+        font.scale = 0.8f;
+        return { CellWidth, 40, font, font, font };
+    }
+
+    enum class Mode { Unconditional, ETag, LastModified };
+
+    struct RefreshRun {
+        std::size_t notModified = 0;
+        std::size_t parsed = 0; // articles parsed and laid out over all refreshes
+        double parseSeconds = 0;
+    };
+
+    // What NewsFeed does with the newest page on every refresh: send what it has, and on a 200
+    // parse and lay the page out and keep the new validators
+    RefreshRun refresh(NewsApiStub& stub, steamfeed::HttpValidators& saved, Mode mode, int times,
+        const steamfeed::NewsLayoutStyle& style) {
+        RefreshRun run;
+        auto url = steamfeed::newsUrl(steamfeed::RefreshPageCount);
+        for (int i = 0; i < times; i++) {
+            steamfeed::HttpValidators sent;
+            if (mode == Mode::ETag) {
+                sent.etag = saved.etag;
+            }
+            else if (mode == Mode::LastModified) {
+                sent.lastModified = saved.lastModified;
+            }
+
+            auto response = stub.request(url, sent);
+            if (response.status == 304) {
+                run.notModified++;
+                continue;
+            }
+            auto start = Clock::now();
+            steamfeed::NewsLayout layout(style);
+            steamfeed::parseNewsItems(response.body.data(), response.body.size(), gidRules(), [&](steamfeed::NewsItem&& item) {
+                layout.append(item.title, item.content);
+                run.parsed++;
+                return true;
+            });
+            run.parseSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+            saved = response.validators;
+        }
+        return run;
+    }
+}
+
+// Refreshing an unchanged feed against the stub: downloading and parsing the newest page every
+// time, against conditional requests that come back as a bare 304 once the page is cached.
+// Then the feed changes once, which has to come through as a 200 and be picked up.
+void runConditionalBench(const Options& options, const std::vector<Payload>&) {
+    steamfeed::FontMetrics metrics;
+    metrics.parse(syntheticFnt());
+    auto style = cellStyle(metrics);
+
+    std::printf("\n== conditional: %d refreshes of an unchanged feed, %zu article history\n", Refreshes, options.itemCount);
+    std::printf("%-14s %10s %10s %10s %12s %12s\n", "validator", "requests", "304s", "KB", "parsed", "parse ms");
+    for (auto mode : { Mode::Unconditional, Mode::ETag, Mode::LastModified }) {
+        NewsApiStub stub(options.itemCount);
+        steamfeed::HttpValidators saved;
+        auto run = refresh(stub, saved, mode, Refreshes, style);
+        const char* name = mode == Mode::ETag ? "etag" : mode == Mode::LastModified ? "last-modified" : "none";
+        std::printf("%-14s %10zu %10zu %10.1f %12zu %12.3f\n", name, stub.requests(), run.notModified,
+            static_cast<double>(stub.bytesServed()) / 1024.0, run.parsed, run.parseSeconds * 1e3);
+
+        if (mode != Mode::Unconditional) {
+            stub.update();
+            auto changed = refresh(stub, saved, mode, 1, style);
+            auto after = refresh(stub, saved, mode, 1, style);
+            std::printf("%-14s after an update: %s, then %s\n", "",
+                changed.notModified ? "304 (missed)" : "200", after.notModified ? "304" : "200 (not cached)");
+        }
+    }
+}
+
+}
@@ -0,0 +1,118 @@
+#include "Bench.hpp"
+#include "core/DateFormatter.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <optional>
+#include <string>
+
+namespace bench {
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // keeps the formatting from being optimised away
+    volatile char s_sink;
+
+    // POSIX rules rather than zoneinfo names, so they work without tzdata
+    constexpr const char* Zones[] = {
+        "UTC0",
+        "EST5EDT,M3.2.0,M11.1.0",
+        "GMT0BST,M3.5.0/1,M10.5.0",
+        "AEST-10AEDT,M10.1.0,M4.1.0/3",
+        "NPT-5:45",
+    };
+
+    void setZone(const char* zone) {
+#ifdef _WIN32
+        _putenv_s("TZ", zone ? zone : "");
+        _tzset();
+#else
+        if (zone) {
+            setenv("TZ", zone, 1);
+        }
+        else {
+            unsetenv("TZ");
+        }
+        tzset();
+#endif
+    }
+
+    // Newest first, the way articles come
+    std::vector<std::int64_t> timestamps(std::size_t count, std::int64_t step) {
+        std::vector<std::int64_t> result;
+        std::int64_t time = 1700000000;
+        for (std::size_t i = 0; i < count; i++) {
+            result.push_back(time);
+            time -= step;
+        }
+        return result;
+    }
+
+    void formatLibc(std::int64_t timestamp, char* out) {
+        time_t rawTime = timestamp;
+        struct tm* timeInfo = localtime(&rawTime);
+        strftime(out, steamfeed::NewsDateSize, "%Y-%m-%d", timeInfo);
+    }
+
+    double nanosPerItem(const std::vector<std::int64_t>& times, int iterations, bool formatter) {
+        double best = 1e30;
+        char out[steamfeed::NewsDateSize];
+        for (int i = 0; i < iterations; i++) {
+            auto start = Clock::now();
+            // one formatter per parse, like ParsedFeed
+            steamfeed::DateFormatter dates;
+            for (auto time : times) {
+                if (formatter) {
+                    dates.format(time, out);
+                }
+                else {
+                    formatLibc(time, out);
+                }
+                s_sink = out[9];
+            }
+            best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+        }
+        return best * 1e9 / static_cast<double>(times.size());
+    }
+}
+
+// DateFormatter against localtime + strftime per article: every date compared across years
+// of DST changes in a few zones, then the time per article for a sparse feed (several days
+// apart, like the synthetic one) and a dense one (an article an hour)
+void runDateBench(const Options& options, const std::vector<Payload>&) {
+    std::optional<std::string> savedZone;
+    if (auto zone = std::getenv("TZ")) {
+        savedZone = zone;
+    }
+
+    // every 37 minutes over three years hits both sides of every change
+    auto checked = timestamps(3 * 365 * 24 * 60 / 37, 37 * 60);
+    auto sparse = timestamps(10000, 8 * 86400 + 3 * 3600);
+    auto dense = timestamps(10000, 3600);
+
+    std::printf("\n== dates: %zu timestamps checked per zone\n", checked.size());
+    std::printf("%-30s %10s %14s %14s %14s %14s\n", "zone", "mismatches", "sparse libc", "sparse ns", "dense libc", "dense ns");
+    for (auto zone : Zones) {
+        setZone(zone);
+        std::size_t mismatches = 0;
+        steamfeed::DateFormatter dates;
+        for (auto time : checked) {
+            char expected[steamfeed::NewsDateSize];
+            char actual[steamfeed::NewsDateSize];
+            formatLibc(time, expected);
+            dates.format(time, actual);
+            mismatches += std::string_view(expected) != std::string_view(actual);
+        }
+        std::printf("%-30s %10zu %14.1f %14.1f %14.1f %14.1f\n", zone, mismatches,
+            nanosPerItem(sparse, options.iterations, false), nanosPerItem(sparse, options.iterations, true),
+            nanosPerItem(dense, options.iterations, false), nanosPerItem(dense, options.iterations, true));
+        if (mismatches != 0) {
+            markFailed();
+        }
+    }
+    setZone(savedZone ? savedZone->c_str() : nullptr);
+}
+
+}
@@ -0,0 +1,152 @@
+#include "Bench.hpp"
+#include "SyntheticFeed.hpp"
+#include "core/NewsApi.hpp"
+#include "core/NewsDedup.hpp"
+#include "core/NewsParser.hpp"
+#include <cstdio>
+#include <random>
+
+namespace bench {
+
+namespace {
+    constexpr std::size_t FeedItems = 10000;
+
+    // the gids the rule table skips by hand, reused for the reposts injected below
+    const char* const s_duplicateGids[] = {
+        "5410576585124650573", "2436926440562370340", "2284879949508460627",
+        "2163281492537211231", "2152021858901922963", "2152021858894636598",
+        "2486412956120074597", "3044845282402408345", "4249665521681179987",
+        "4249665521681180090", "4249665521681180188", "295352659733029280",
+        "377538916270267899", "378660375673380952", "371902438121350491",
+        "405678801273981156", "409053962649582461", "518256108464071258",
+        "517128413774920296", "517127039058316220", "515998514243691390",
+        "517122602985592706", "517122602980080996", "511492468646310449",
+        "521624142113331755", "5410576585126249016"
+    };
+
+    enum class Repost { Exact, Reformatted, Edited };
+
+    std::string replaceAll(std::string text, std::string_view from, std::string_view to) {
+        for (auto pos = text.find(from); pos != std::string::npos; pos = text.find(from, pos + to.size())) {
+            text.replace(pos, from.size(), to);
+        }
+        return text;
+    }
+
+    steamfeed::NewsItem makeRepost(const steamfeed::NewsItem& original, Repost kind, const char* gid) {
+        auto repost = original;
+        repost.gid = gid;
+        if (kind == Repost::Reformatted) {
+            // same words, different markup and whitespace
+            repost.title = "[b]" + replaceAll(repost.title, " ", "  ") + "[/b]";
+            repost.content = replaceAll(repost.content, "\n", "\r\n\r\n");
+        }
+        else if (kind == Repost::Edited) {
+            // one word added in the middle, like a late correction
+            auto middle = repost.content.find(' ', repost.content.size() / 2);
+            repost.content.insert(middle, " corrected");
+        }
+        return repost;
+    }
+
+    struct Injected {
+        std::vector<steamfeed::NewsItem> items;
+        std::vector<Repost> kinds; // per item, only meaningful where isRepost is set
+        std::vector<bool> isRepost;
+    };
+
+    // The synthetic feed with reposts of earlier articles slipped in after their originals,
+    // one per hard-coded gid, cycling through the kinds of repost
+    Injected injectReposts(std::vector<steamfeed::NewsItem> feed) {
+        std::mt19937 rng(9);
+        Injected injected;
+        injected.items = std::move(feed);
+        injected.isRepost.assign(injected.items.size(), false);
+        injected.kinds.assign(injected.items.size(), Repost::Exact);
+
+        int index = 0;
+        for (auto gid : s_duplicateGids) {
+            auto kind = static_cast<Repost>(index++ % 3);
+            auto original = rng() % (injected.items.size() / 2);
+            while (injected.isRepost[original]) {
+                original++;
+            }
+            auto position = original + 1 + rng() % (injected.items.size() - original - 1);
+
+            auto repost = makeRepost(injected.items[original], kind, gid);
+            injected.items.insert(injected.items.begin() + position, std::move(repost));
+            injected.isRepost.insert(injected.isRepost.begin() + position, true);
+            injected.kinds.insert(injected.kinds.begin() + position, kind);
+        }
+        return injected;
+    }
+
+    // An original dropped always fails the run. A repost missed only does when the mode is meant
+    // to catch them all, the baseline has to miss some or the reposts never crossed a page.
+    void checkDropped(const char* mode, const Injected& injected, const std::vector<bool>& dropped, bool catchesEdits,
+        bool missesSome = false) {
+        int missed = 0;
+        int wrong = 0;
+        for (std::size_t i = 0; i < injected.items.size(); i++) {
+            bool expected = injected.isRepost[i] && (catchesEdits || injected.kinds[i] != Repost::Edited);
+            missed += expected && !dropped[i];
+            wrong += !injected.isRepost[i] && dropped[i];
+        }
+        std::printf("%-12s %d reposts missed, %d originals dropped\n", mode, missed, wrong);
+        if (wrong != 0 || (missesSome ? missed == 0 : missed != 0)) {
+            std::printf("FAILED: %s dedup dropped the wrong articles\n", mode);
+            markFailed();
+        }
+    }
+}
+
+// One linear dedup pass over 10k synthetic articles with reposts injected under the gids the
+// rule table used to skip by hand: exact repeats only vs SimHash near-duplicates as well
+void runDedupBench(const Options& options, const std::vector<Payload>&) {
+    auto feed = steamfeed::parseRawNewsItems(makeSyntheticFeed(FeedItems), steamfeed::GidRuleTable());
+    auto injected = injectReposts(std::move(feed));
+    const auto& items = injected.items;
+
+    std::size_t bytes = 0;
+    for (const auto& item : items) {
+        bytes += item.title.size() + item.content.size();
+    }
+
+    std::printf("\n== dedup: %zu articles, %zu reposts\n", items.size(), std::size(s_duplicateGids));
+    std::vector<bool> dropped(items.size());
+    auto run = [&](int maxDistance) {
+        steamfeed::NewsDedup dedup(maxDistance);
+        for (std::size_t i = 0; i < items.size(); i++) {
+            dropped[i] = dedup.isDuplicate(items[i].title, items[i].content);
+        }
+    };
+
+    run(0);
+    checkDropped("exact", injected, dropped, false);
+    run(6);
+    checkDropped("simhash", injected, dropped, true);
+
+    // the feed comes in older pages of OlderPageCount articles, a dedup per page only sees
+    // the reposts within one of them, the feed's own set sees them across pages
+    auto runPaged = [&](bool feedWide) {
+        steamfeed::NewsDedup dedup;
+        for (std::size_t i = 0; i < items.size(); i++) {
+            if (!feedWide && i % steamfeed::OlderPageCount == 0) {
+                dedup.clear();
+            }
+            dropped[i] = dedup.isDuplicate(items[i].title, items[i].content);
+        }
+    };
+    runPaged(false);
+    checkDropped("per-page", injected, dropped, true, true);
+    runPaged(true);
+    checkDropped("feed-wide", injected, dropped, true);
+
+    reportHeader("dedup: " + std::to_string(items.size()) + " articles");
+    auto exact = measure(options.iterations, [&] { run(0); });
+    report("exact", exact, bytes, items.size());
+    auto simHash = measure(options.iterations, [&] { run(6); });
+    report("simhash", simHash, bytes, items.size());
+}
+
+}
@@ -0,0 +1,118 @@
+#include "Bench.hpp"
+#include "LegacyPipeline.hpp"
+#include "core/FontMetrics.hpp"
+#include "core/NewsParser.hpp"
+#include "core/TextWrap.hpp"
+#include <cstdio>
+
+namespace bench {
+
+std::string syntheticFnt() {
+    std::string fnt = "info face=\"synthetic\" size=64\ncommon lineHeight=80 base=64 scaleW=1024 scaleH=1024\n";
+    for (int id = 32; id < 127; id++) {
+        fnt += "char id=" + std::to_string(id) + " x=0 y=0 width=40 height=60 xoffset=0 yoffset=0 xadvance="
+            + std::to_string(28 + id * 7 % 24) + " page=0 chnl=0\n";
+    }
+    for (auto pair : { "AV", "To", "Ty", "LT", "Yo" }) {
+        fnt += "kerning first=" + std::to_string(pair[0]) + " second=" + std::to_string(pair[1]) + " amount=-4\n";
+    }
+    return fnt;
+}
+
+namespace {
+    // the title column of the layer in goldFont pixels at the -uhd scale, near enough
+    constexpr float TitleWidth = 1600.0f;
+
+    struct Font {
+        std::string name;
+        steamfeed::FontMetrics metrics;
+    };
+
+    std::vector<Font> loadFonts(const Options& options) {
+        std::vector<Font> fonts;
+        for (const auto& path : options.fontFiles) {
+            Font font{ path, {} };
+            if (!font.metrics.loadFile(path)) {
+                std::fprintf(stderr, "steamfeed_bench: cannot read font metrics from %s\n", path.c_str());
+                continue;
+            }
+            fonts.push_back(std::move(font));
+        }
+        if (options.fontFiles.empty()) {
+            Font font{ "synthetic.fnt", {} };
+            font.metrics.parse(syntheticFnt());
+            fonts.push_back(std::move(font));
+        }
+        return fonts;
+    }
+}
+
+// Wrapping every title the way the layer does it: the old stringstream wrap measuring each word
+// from scratch, the new wrap with direct glyph sums, and with the per-word LRU in front of them.
+// The layer used to create a CCLabelBMFont per word, which has no headless equivalent.
+void runFontBench(const Options& options, const std::vector<Payload>& payloads) {
+    auto fonts = loadFonts(options);
+
+    for (const auto& payload : payloads) {
+        auto items = steamfeed::parseRawNewsItems(payload.body, gidRules());
+        std::size_t bytes = 0;
+        for (const auto& item : items) {
+            bytes += item.title.size();
+        }
+
+        for (const auto& font : fonts) {
+            const auto& metrics = font.metrics;
+            auto maxWidth = TitleWidth;
+
+            std::vector<std::string> expected(items.size());
+            std::vector<std::string> wrapped(items.size());
+            steamfeed::WordWidthCache cache;
+            int mismatches = 0;
+            for (std::size_t i = 0; i < items.size(); i++) {
+                expected[i] = legacy::wrapText(items[i].title, maxWidth, [&](const std::string& word) { return metrics.measure(word); });
+                auto direct = steamfeed::wrapText(items[i].title, maxWidth, [&](std::string_view word) { return metrics.measure(word); });
+                auto cached = steamfeed::wrapText(items[i].title, maxWidth, [&](std::string_view word) { return cache.measure(metrics, word); });
+                mismatches += direct != expected[i] || cached != expected[i];
+            }
+
+            reportHeader("fonts: titles of " + payload.name + " in " + font.name + ", " + std::to_string(mismatches) + " mismatches");
+            if (mismatches != 0) {
+                markFailed();
+            }
+            auto before = measure(options.iterations, [&] {
+                for (std::size_t i = 0; i < items.size(); i++) {
+                    wrapped[i] = legacy::wrapText(items[i].title, maxWidth, [&](const std::string& word) { return metrics.measure(word); });
+                }
+            });
+            report("stream", before, bytes, items.size());
+
+            auto direct = measure(options.iterations, [&] {
+                for (std::size_t i = 0; i < items.size(); i++) {
+                    wrapped[i] = steamfeed::wrapText(items[i].title, maxWidth, [&](std::string_view word) { return metrics.measure(word); });
+                }
+            });
+            report("glyph-sum", direct, bytes, items.size());
+
+            auto cold = measure(options.iterations, [&] {
+                steamfeed::WordWidthCache fresh;
+                for (std::size_t i = 0; i < items.size(); i++) {
+                    wrapped[i] = steamfeed::wrapText(items[i].title, maxWidth, [&](std::string_view word) { return fresh.measure(metrics, word); });
+                }
+            });
+            report("lru-cold", cold, bytes, items.size());
+
+            auto warm = measure(options.iterations, [&] {
+                for (std::size_t i = 0; i < items.size(); i++) {
+                    wrapped[i] = steamfeed::wrapText(items[i].title, maxWidth, [&](std::string_view word) { return cache.measure(metrics, word); });
+                }
+            });
+            report("lru-warm", warm, bytes, items.size());
+
+            std::printf("%.2f us/title with the warm cache, %zu words cached, %.1f%% hits\n",
+                warm.seconds * 1e6 / static_cast<double>(std::max<std::size_t>(items.size(), 1)), cache.size(),
+                100.0 * static_cast<double>(cache.hits()) / static_cast<double>(std::max<std::uint64_t>(cache.hits() + cache.misses(), 1)));
+        }
+    }
+}
+
+}
@@ -0,0 +1,51 @@
+#include "Bench.hpp"
+#include "core/NewsParser.hpp"
+#include <cstdio>
+#include <string>
+
+namespace bench {
+
+// The full pipeline into owning NewsItems against ParsedFeed, which takes the response over
+// and parses it in place. Both start from a response string that already exists, the way the
+// web layer hands it over, so the peak column is only what parsing adds on top of it.
+void runInSituBench(const Options& options, const std::vector<Payload>& payloads) {
+    for (const auto& payload : payloads) {
+        auto expected = steamfeed::parseNewsItems(payload.body, gidRules());
+        steamfeed::ParsedFeed check;
+        bool parsed = check.parse(payload.body, gidRules());
+        std::size_t mismatches = check.size() != expected.size();
+        for (std::size_t i = 0; i < std::min(check.size(), expected.size()); i++) {
+            const auto& view = check[i];
+            const auto& item = expected[i];
+            mismatches += view.gid != item.gid || view.title != item.title || view.content != item.content
+                || view.date != item.date || view.timestamp != item.timestamp
+                || view.content.data()[view.content.size()] != '\0' || view.date.data()[view.date.size()] != '\0';
+        }
+
+        reportHeader("insitu: " + payload.name + ", " + std::to_string(payload.body.size() / 1024) + " KB response, "
+            + std::to_string(mismatches) + " mismatches" + (parsed ? "" : ", parse failed"));
+        if (mismatches != 0 || !parsed) {
+            markFailed();
+        }
+
+        std::vector<std::string> responses(options.iterations, payload.body);
+        std::size_t next = 0;
+        std::size_t items = 0;
+        auto owning = measure(options.iterations, [&] {
+            auto response = std::move(responses[next++]);
+            items = steamfeed::parseNewsItems(response, gidRules()).size();
+        });
+        report("news-items", owning, payload.body.size(), items);
+
+        responses.assign(options.iterations, payload.body);
+        next = 0;
+        auto inSitu = measure(options.iterations, [&] {
+            steamfeed::ParsedFeed feed;
+            feed.parse(std::move(responses[next++]), gidRules());
+            items = feed.size();
+        });
+        report("in-situ", inSitu, payload.body.size(), items);
+    }
+}
+
+}
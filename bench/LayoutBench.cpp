@@ -0,0 +1,116 @@
+#include "Bench.hpp"
+#include "core/FontMetrics.hpp"
+#include "core/NewsLayout.hpp"
+#include "core/NewsParser.hpp"
+#include <cstdio>
+
+namespace bench {
+
+namespace {
+    // the layer's cell on a 569 point wide window at the -uhd scale
+    constexpr float CellWidth = 419.0f;
+    constexpr float PixelsPerPoint = 4.0f;
+
+    steamfeed::LayoutFont layoutFont(const steamfeed::FontMetrics& metrics, float scale, steamfeed::WordWidthCache* cache) {
+        steamfeed::LayoutFont font;
+        font.scale = scale;
+        font.lineHeight = static_cast<float>(metrics.lineHeight()) / PixelsPerPoint;
+        if (cache) {
+            font.measure = [&metrics, cache](std::string_view word) { return cache->measure(metrics, word) / PixelsPerPoint; };
+        }
+        else {
+            font.measure = [&metrics](std::string_view word) { return metrics.measure(word) / PixelsPerPoint; };
+        }
+        return font;
+    }
+
+    // NewsCell's fonts, all three played by the same metrics
+    steamfeed::NewsLayoutStyle cellStyle(const steamfeed::FontMetrics& metrics, steamfeed::WordWidthCache* cache) {
+        steamfeed::NewsLayoutStyle style;
+        style.width = CellWidth;
+        style.title = layoutFont(metrics, 0.8f, cache);
+        style.date = layoutFont(metrics, 0.4f, cache);
+        style.content = layoutFont(metrics, 0.8f, cache);
+        return style;
+    }
+
+    // Content lines of more than one word that came out wider than the label, should be none
+    std::size_t countOverflows(const steamfeed::NewsLayout& layout, const std::vector<steamfeed::NewsItem>& items,
+        const steamfeed::FontMetrics& metrics) {
+        std::size_t overflows = 0;
+        std::string line;
+        for (std::size_t i = 0; i < items.size(); i++) {
+            for (auto span : layout.contentLines(i)) {
+                steamfeed::NewsLayout::joinLines(items[i].content, { &span, 1 }, line);
+                bool oneWord = line.find(' ') == std::string::npos;
+                overflows += !oneWord && metrics.measure(line) / PixelsPerPoint * 0.8f > CellWidth;
+            }
+        }
+        return overflows;
+    }
+}
+
+// Laying out the whole feed headlessly: the line breaks, positions and heights NewsCell used
+// to get by creating a throwaway content label per article and then laying out the content
+// and its shadow again, which has no headless equivalent to compare against.
+void runLayoutBench(const Options& options, const std::vector<Payload>& payloads) {
+    steamfeed::FontMetrics metrics;
+    if (options.fontFiles.empty() || !metrics.loadFile(options.fontFiles.front())) {
+        metrics.parse(syntheticFnt());
+    }
+
+    for (const auto& payload : payloads) {
+        auto items = steamfeed::parseNewsItems(payload.body, gidRules());
+        std::size_t bytes = 0;
+        for (const auto& item : items) {
+            bytes += item.title.size() + item.content.size();
+        }
+
+        steamfeed::WordWidthCache cache;
+        steamfeed::NewsLayout layout(cellStyle(metrics, &cache));
+        std::size_t lines = 0;
+        for (const auto& item : items) {
+            const auto& article = layout.append(item.title, item.content);
+            lines += article.titleLines + article.contentLines;
+        }
+
+        reportHeader("layout: " + payload.name + ", " + std::to_string(lines) + " lines over "
+            + std::to_string(static_cast<long long>(layout.totalHeight())) + " points, "
+            + std::to_string(countOverflows(layout, items, metrics)) + " overflowing");
+
+        steamfeed::NewsLayout direct(cellStyle(metrics, nullptr));
+        auto uncached = measure(options.iterations, [&] {
+            direct.clear();
+            for (const auto& item : items) {
+                direct.append(item.title, item.content);
+            }
+        });
+        report("glyph-sum", uncached, bytes, items.size());
+
+        auto cold = measure(options.iterations, [&] {
+            steamfeed::WordWidthCache fresh;
+            steamfeed::NewsLayout fromScratch(cellStyle(metrics, &fresh));
+            for (const auto& item : items) {
+                fromScratch.append(item.title, item.content);
+            }
+        });
+        report("lru-cold", cold, bytes, items.size());
+
+        auto warm = measure(options.iterations, [&] {
+            layout.clear();
+            for (const auto& item : items) {
+                layout.append(item.title, item.content);
+            }
+        });
+        report("lru-warm", warm, bytes, items.size());
+
+        std::printf("%.2f us/article with the warm cache, total height %s the per-article sum\n",
+            warm.seconds * 1e6 / static_cast<double>(std::max<std::size_t>(items.size(), 1)),
+            direct.totalHeight() == layout.totalHeight() ? "matches" : "DIFFERS from");
+        if (direct.totalHeight() != layout.totalHeight()) {
+            markFailed();
+        }
+    }
+}
+
+}
@@ -0,0 +1,154 @@
+#include "LegacyPipeline.hpp"
+#include "Bench.hpp"
+#include <algorithm>
+#include <ctime>
+#include <set>
+#include <sstream>
+#include <rapidjson/document.h>
+
+using namespace rapidjson;
+using steamfeed::NewsItem;
+
+namespace legacy {
+
+bool isSkippedGid(const std::string& gid) {
+    // skipping duplicate articles based on the gid
+    static const std::set<std::string> skipGids = {
+        "5410576585124650573", "2436926440562370340", "2284879949508460627",
+        "2163281492537211231", "2152021858901922963", "2152021858894636598",
+        "2486412956120074597", "3044845282402408345", "4249665521681179987",
+        "4249665521681180090", "4249665521681180188", "295352659733029280",
+        "377538916270267899", "378660375673380952", "371902438121350491",
+        "405678801273981156", "409053962649582461", "518256108464071258",
+        "517128413774920296", "517127039058316220", "515998514243691390",
+        "517122602985592706", "517122602980080996", "511492468646310449",
+        "521624142113331755"
+    };
+    return skipGids.find(gid) != skipGids.end();
+}
+
+std::vector<NewsItem> parseRawNewsItems(const std::string& response) {
+    std::vector<NewsItem> newsItems;
+
+    // same DOM as before, only with its memory routed through the bench counters
+    GenericDocument<UTF8<>, MemoryPoolAllocator<bench::CountedCrtAllocator>, bench::CountedCrtAllocator> document;
+    document.Parse(response.c_str());
+
+    if (!document.HasParseError() && document.IsObject()) {
+        const auto& appNews = document["appnews"];
+        const auto& newsItemsArray = appNews["newsitems"];
+        for (auto& newsItem : newsItemsArray.GetArray()) {
+            NewsItem item;
+            std::string gid = newsItem["gid"].GetString();
+            if (isSkippedGid(gid)) {
+                continue;
+            }
+            item.gid = gid;
+            item.title = newsItem["title"].GetString();
+            item.content = newsItem["contents"].GetString();
+
+            // converting the current date format to readable date
+            if (newsItem.HasMember("date")) {
+                time_t rawTime = newsItem["date"].GetInt64();
+                struct tm* timeInfo = localtime(&rawTime);
+                char buffer[11];
+                strftime(buffer, sizeof(buffer), "%Y-%m-%d", timeInfo);
+                item.date = buffer;
+            }
+
+            if (gid != "5410576585126249016") {
+                newsItems.push_back(std::move(item));
+            }
+        }
+    }
+
+    return newsItems;
+}
+
+std::string removeUnwantedParts(const std::string& text, const std::string& gid) {
+    std::string result = text;
+    size_t pos;
+
+    // The removed portions of text
+    while ((pos = result.find("previewyoutube=")) != std::string::npos) {
+        size_t endPos = result.find(" ", pos);
+        result.erase(pos, endPos - pos + 1);
+    }
+
+    while ((pos = result.find("url=")) != std::string::npos) {
+        size_t endPos = result.find(" ", pos);
+        result.erase(pos, endPos - pos + 1);
+    }
+    while ((pos = result.find("/url")) != std::string::npos) {
+        size_t endPos = result.find(" ", pos);
+        result.erase(pos, endPos - pos + 1);
+    }
+
+    // Removing [, and ]
+    result.erase(std::remove(result.begin(), result.end(), '['), result.end());
+    result.erase(std::remove(result.begin(), result.end(), ']'), result.end());
+
+    // Removing the occurrence of "/list"
+    while ((pos = result.find("/list")) != std::string::npos) {
+        result.erase(pos, 5);
+    }
+
+    // Removing duplicate article with gid "5218041989051270041"
+    if (gid == "5218041989051270041") {
+        result.erase(std::remove(result.begin(), result.end(), '/'), result.end());
+    }
+
+    // Removing duplicate article with gid "5124585319850001325"
+    if (gid == "5124585319850001325") {
+        while ((pos = result.find("[img]{STEAM_CLAN_IMAGE}/7432088/4fcada2e76dd5b2839d84e420a53315d8e078f98.png")) != std::string::npos) {
+            result.erase(pos, 74);
+        }
+    }
+
+    // Replacing the words "/Ru" or "/Rub" with "/RubRub" for full text string.
+    std::istringstream stream(result);
+    std::string word;
+    std::string finalResult;
+
+    while (stream >> word) {
+        if (word.find("/Ru") != std::string::npos || word.find("/Rub") != std::string::npos) {
+            word = "/RubRub";
+        }
+        finalResult += word + " ";
+    }
+
+    // Trimmed trailing spacing.
+    if (!finalResult.empty()) {
+        finalResult.pop_back();
+    }
+
+    return finalResult;
+}
+
+std::string wrapText(const std::string& text, float maxWidth, const std::function<float(const std::string&)>& measure) {
+    std::stringstream wrappedText;
+    std::stringstream lineStream;
+    std::istringstream wordStream(text);
+    std::string word;
+    float lineWidth = 0;
+    float buffer = -100;  // Setting the buffer for longer lines before wrapping happens.
+
+    while (wordStream >> word) {
+        float wordWidth = measure(word);
+
+        if (lineWidth + wordWidth + buffer > maxWidth) {
+            wrappedText << lineStream.str() << '\n';
+            lineStream.str("");
+            lineWidth = 0;
+        }
+
+        lineStream << word << ' ';
+        lineWidth += wordWidth;
+    }
+
+    wrappedText << lineStream.str();
+
+    return wrappedText.str();
+}
+
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "core/NewsItem.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+// The pipeline as it shipped before the core rewrites, kept as the baseline the
+// benchmarks compare against and as the reference output for equivalence checks
+namespace legacy {
+
+// The hard-coded std::set of skipped gids, without the separate "5410576585126249016" check
+bool isSkippedGid(const std::string& gid);
+
+// rapidjson::Document based parse, every string copied into the DOM and then into the item
+std::vector<steamfeed::NewsItem> parseRawNewsItems(const std::string& response);
+
+// Repeated find/erase loops, std::remove passes and an istringstream re-tokenise.
+// Hangs on a text that starts with a marker with no space anywhere after it.
+std::string removeUnwantedParts(const std::string& text, const std::string& gid);
+
+// stringstream word wrap, measuring every word through measure
+std::string wrapText(const std::string& text, float maxWidth, const std::function<float(const std::string&)>& measure);
+
+}
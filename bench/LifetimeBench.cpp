@@ -0,0 +1,265 @@
+#include "Bench.hpp"
+#include "NewsStub.hpp"
+#include "core/FeedStore.hpp"
+#include "core/FeedWorker.hpp"
+#include "core/FontMetrics.hpp"
+#include "core/NewsApi.hpp"
+#include "core/NewsLayout.hpp"
+#include "core/NewsParser.hpp"
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+
+namespace bench {
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Cycles = 60;
+    constexpr auto ServerDelay = std::chrono::milliseconds(20);
+    constexpr std::size_t BatchSize = 32;
+    constexpr float CellWidth = 419.0f;
+    constexpr float PixelsPerPoint = 4.0f;
+
+    // The main thread's event queue, where the web layer delivers responses
+    class MainQueue {
+    public:
+        void push(std::function<void()> event) {
+            std::lock_guard lock(m_mutex);
+            m_events.push_back(std::move(event));
+        }
+        void drain() {
+            std::deque<std::function<void()>> events;
+            {
+                std::lock_guard lock(m_mutex);
+                events.swap(m_events);
+            }
+            for (auto& event : events) {
+                event();
+            }
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::deque<std::function<void()>> m_events;
+    };
+
+    struct Counters {
+        std::size_t completions = 0;
+        std::size_t completionsAfterClose = 0; // fetches that finished with the layer that wanted them gone
+        std::size_t eventsAfterClose = 0;      // listener calls into a closed layer
+    };
+
+    // Stands in for NewsFeed: lives for the whole run, fetches from a slow server, parses on its
+    // worker and streams the articles into its store in batches, whoever is subscribed by then
+    class Feed {
+    public:
+        Feed(const std::string& body, MainQueue& main) : m_body(body), m_main(main) {
+            m_metrics.parse(syntheticFnt());
+            steamfeed::LayoutFont font;
+            font.lineHeight = static_cast<float>(m_metrics.lineHeight()) / PixelsPerPoint;
+            font.measure = [this](std::string_view word) { return m_metrics.measure(word) / PixelsPerPoint; };
+            font.scale = 0.8f;
+            m_style = { CellWidth, 40, font, font, font };
+        }
+
+        ~Feed() {
+            for (auto& request : m_requests) {
+                request.join();
+            }
+        }
+
+        steamfeed::FeedStore& store() { return m_store; }
+        bool fetching() const { return m_fetching; }
+
+        void poll() {
+            m_main.drain();
+            m_worker.poll();
+        }
+
+        // done runs on the main thread once the whole feed is in the store
+        void fetch(std::function<void()> done) {
+            m_fetching = true;
+            m_requests.emplace_back([this, done = std::move(done)] {
+                std::this_thread::sleep_for(ServerDelay);
+                m_main.push([this, done] { onResponse(done); });
+            });
+        }
+
+    private:
+        struct Batch {
+            std::vector<steamfeed::NewsItem> items;
+            steamfeed::NewsLayout layout;
+        };
+
+        void onResponse(const std::function<void()>& done) {
+            auto worker = &m_worker;
+            m_worker.post([this, worker] {
+                auto batch = std::make_shared<Batch>(Batch{ {}, steamfeed::NewsLayout(m_style) });
+                bool first = true;
+                auto flush = [&] {
+                    worker->publish([this, batch, first] {
+                        if (first) {
+                            m_store.replace(std::move(batch->items), std::move(batch->layout));
+                        }
+                        else {
+                            m_store.append(std::move(batch->items), batch->layout);
+                        }
+                    });
+                    batch = std::make_shared<Batch>(Batch{ {}, steamfeed::NewsLayout(m_style) });
+                    first = false;
+                };
+                steamfeed::parseNewsItems(m_body.data(), m_body.size(), gidRules(), [&](steamfeed::NewsItem&& item) {
+                    batch->layout.append(item.title, item.content);
+                    batch->items.push_back(std::move(item));
+                    if (batch->items.size() >= BatchSize) {
+                        flush();
+                    }
+                    return true;
+                });
+                flush();
+            }, [this, done] {
+                m_fetching = false;
+                done();
+            });
+        }
+
+        const std::string& m_body;
+        MainQueue& m_main;
+        steamfeed::FontMetrics m_metrics;
+        steamfeed::NewsLayoutStyle m_style;
+        steamfeed::FeedStore m_store;
+        bool m_fetching = false;
+        std::deque<std::thread> m_requests;
+        steamfeed::FeedWorker m_worker; // last, joined first
+    };
+
+    // How a layer goes away
+    enum class Ending {
+        LeftOn,  // the old bug: closed, but still subscribed
+        Close,   // SteamNewsLayer::closePopup, which resets its subscription
+        Destroy, // the layer released without closePopup, its subscription's destructor unsubscribes
+    };
+
+    // Holds its FeedSubscription the way SteamNewsLayer does, subscribing on open and kicking
+    // off a refresh. The feed then finishes loading for the next layer, whatever this one did.
+    class Layer {
+    public:
+        Layer(Feed& feed, Counters& counters) : m_closed(std::make_shared<bool>(false)) {
+            // the flag outlives the layer, so a listener left behind is counted rather than
+            // running on a freed layer
+            m_subscription = steamfeed::FeedSubscription(feed.store(),
+                [this, closed = m_closed, &counters](const steamfeed::FeedStore::Snapshot& snapshot, steamfeed::FeedChange, std::size_t) {
+                    if (*closed) {
+                        counters.eventsAfterClose++;
+                        return;
+                    }
+                    m_shown = snapshot;
+                });
+        }
+
+        ~Layer() {
+            *m_closed = true;
+        }
+
+        void close(bool unsubscribes) {
+            *m_closed = true;
+            if (unsubscribes) {
+                m_subscription.reset();
+            }
+        }
+
+        const std::shared_ptr<bool>& closedFlag() const { return m_closed; }
+
+    private:
+        std::shared_ptr<bool> m_closed;
+        steamfeed::FeedStore::Snapshot m_shown;
+        steamfeed::FeedSubscription m_subscription;
+    };
+
+    // Opens a layer and ends it at a random point of the load, over and over. Layers only
+    // closed are kept around, so a listener left behind can still be counted.
+    void openAndClose(Ending ending, const std::string& body, Counters& counters) {
+        MainQueue main;
+        Feed feed(body, main);
+        std::deque<Layer> layers;
+        std::mt19937 rng(17);
+        for (int cycle = 0; cycle < Cycles; cycle++) {
+            auto& layer = layers.emplace_back(feed, counters);
+            if (!feed.fetching()) {
+                feed.fetch([&counters, closed = layer.closedFlag()] {
+                    counters.completions++;
+                    counters.completionsAfterClose += *closed;
+                });
+            }
+
+            auto closeAt = Clock::now() + std::chrono::milliseconds(rng() % 150);
+            while (Clock::now() < closeAt) {
+                feed.poll();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            if (ending == Ending::Destroy) {
+                layers.pop_back();
+            }
+            else {
+                layer.close(ending == Ending::Close);
+            }
+
+            // the fetch goes on without the layer
+            while (feed.fetching()) {
+                feed.poll();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+}
+
+// Opens and ends a layer against a slow stub server many times, at random points of the load,
+// through the FeedSubscription SteamNewsLayer holds. The feed keeps fetching and publishing
+// after the close, and none of that may reach a layer that reset its subscription or was
+// destroyed. Layers that stay subscribed have to see it arrive, or the scenario isn't ending
+// anything mid-load.
+void runLifetimeBench(const Options& options, const std::vector<Payload>&) {
+    NewsApiStub stub(options.itemCount);
+    auto body = stub.respond(steamfeed::newsUrl(static_cast<int>(options.itemCount)));
+
+    std::printf("\n== lifetime: %d open/close cycles, %lld ms server delay, %zu KB feed\n", Cycles,
+        static_cast<long long>(ServerDelay.count()), body.size() / 1024);
+    std::printf("%-12s %10s %12s %12s\n", "mode", "completed", "done-after", "events-after");
+    const std::pair<Ending, const char*> endings[] = {
+        { Ending::LeftOn, "left-on" },
+        { Ending::Close, "close" },
+        { Ending::Destroy, "destroy" },
+    };
+    for (auto [ending, name] : endings) {
+        Counters counters;
+        openAndClose(ending, body, counters);
+        std::printf("%-12s %10zu %12zu %12zu\n", name, counters.completions, counters.completionsAfterClose,
+            counters.eventsAfterClose);
+
+        bool failed = false;
+        if (counters.completionsAfterClose == 0) {
+            std::printf("FAILED: no fetch completed after its layer closed, nothing was checked\n");
+            failed = true;
+        }
+        if (ending != Ending::LeftOn && counters.eventsAfterClose != 0) {
+            std::printf("FAILED: listeners ran after their layer went away\n");
+            failed = true;
+        }
+        if (ending == Ending::LeftOn && counters.eventsAfterClose == 0) {
+            std::printf("FAILED: nothing reached the layers left subscribed after they closed\n");
+            failed = true;
+        }
+        if (failed) {
+            markFailed();
+        }
+    }
+}
+
+}
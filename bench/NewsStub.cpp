@@ -0,0 +1,57 @@
+#include "NewsStub.hpp"
+#include "SyntheticFeed.hpp"
+#include <charconv>
+#include <ctime>
+#include <string_view>
+
+namespace bench {
+
+namespace {
+    // The value of a query parameter, 0 when it's missing
+    std::int64_t queryValue(std::string_view url, std::string_view name) {
+        auto query = url.find('?');
+        while (query != std::string_view::npos) {
+            auto start = query + 1;
+            if (url.substr(start, name.size()) == name && url.substr(start + name.size(), 1) == "=") {
+                std::int64_t value = 0;
+                auto digits = start + name.size() + 1;
+                std::from_chars(url.data() + digits, url.data() + url.size(), value);
+                return value;
+            }
+            query = url.find('&', start);
+        }
+        return 0;
+    }
+}
+
+std::string NewsApiStub::respond(const std::string& url) {
+    return request(url).body;
+}
+
+StubResponse NewsApiStub::request(const std::string& url, const steamfeed::HttpValidators& conditional) {
+    auto count = static_cast<std::size_t>(queryValue(url, "count"));
+    auto endDate = queryValue(url, "enddate");
+    m_requests++;
+
+    // a page only changes with the feed's revision, which is all its validators have to go by
+    StubResponse response;
+    response.validators.etag = "\"r" + std::to_string(m_revision) + "-c" + std::to_string(count) + "-e" + std::to_string(endDate) + "\"";
+    std::time_t modified = 1700000000 + static_cast<std::time_t>(m_revision) * 3600;
+    char date[64];
+    std::strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S GMT", std::gmtime(&modified));
+    response.validators.lastModified = date;
+
+    bool unchanged = !conditional.etag.empty() ? conditional.etag == response.validators.etag
+        : !conditional.lastModified.empty() && conditional.lastModified == response.validators.lastModified;
+    if (unchanged) {
+        response.status = 304;
+        m_notModified++;
+        return response;
+    }
+
+    response.body = makeSyntheticPage(m_historySize, count, endDate, 322170 + m_revision);
+    m_bytesServed += response.body.size();
+    return response;
+}
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "core/HttpValidators.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace bench {
+
+struct StubResponse {
+    int status = 200;
+    std::string body; // empty on a 304
+    steamfeed::HttpValidators validators;
+};
+
+// Stands in for GetNewsForApp: answers request urls with pages of the synthetic feed, going
+// by their count and enddate parameters like the real endpoint
+class NewsApiStub {
+public:
+    explicit NewsApiStub(std::size_t historySize) : m_historySize(historySize) {}
+
+    std::string respond(const std::string& url);
+    // A conditional GET: a 304 when the page still matches the validators the client sent,
+    // If-None-Match taking precedence over If-Modified-Since
+    StubResponse request(const std::string& url, const steamfeed::HttpValidators& conditional = {});
+    // Publishes a new revision of the feed, every page changes along with its validators
+    void update() { m_revision++; }
+
+    std::size_t requests() const { return m_requests; }
+    std::size_t bytesServed() const { return m_bytesServed; }
+    std::size_t notModified() const { return m_notModified; }
+
+private:
+    std::size_t m_historySize;
+    std::uint32_t m_revision = 0;
+    std::size_t m_requests = 0;
+    std::size_t m_bytesServed = 0;
+    std::size_t m_notModified = 0;
+};
+
+}
@@ -0,0 +1,201 @@
+#include "Bench.hpp"
+#include "NewsStub.hpp"
+#include "SyntheticFeed.hpp"
+#include "core/FeedPager.hpp"
+#include "core/NewsApi.hpp"
+#include "core/NewsParser.hpp"
+#include "core/VirtualList.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <unordered_set>
+
+namespace bench {
+
+namespace {
+    // the layer's numbers
+    constexpr float ViewHeight = 320.0f;
+    constexpr float LoadOlderDistance = 600.0f;
+    // a fast fling, and a page taking a quarter second to come back at 60 fps
+    constexpr float ScrollPerFrame = 60.0f;
+    constexpr std::size_t LatencyFrames = 15;
+    constexpr std::size_t MaxFrames = 200000;
+
+    float estimateHeight(const steamfeed::NewsItem& item) {
+        return 50 + std::ceil(static_cast<float>(item.content.size()) * 7.0f / 419.0f) * 20.0f;
+    }
+
+    struct PendingPage {
+        std::string url;
+        std::size_t dueFrame;
+    };
+
+    struct PagingRun {
+        std::vector<steamfeed::NewsItem> items;
+        std::size_t asks = 0;       // times the scroll view wanted more
+        std::size_t suppressed = 0; // of those, dropped while a page was on its way
+        std::size_t frames = 0;
+    };
+
+    // The reader starts on the first page and flings to the bottom until the feed runs out,
+    // the pager fetching from the stub with some latency in between
+    PagingRun scrollToTheEnd(NewsApiStub& stub) {
+        PagingRun run;
+        steamfeed::VirtualList list;
+        auto append = [&](std::vector<steamfeed::NewsItem>&& page) {
+            for (auto& item : page) {
+                list.append(estimateHeight(item), 40);
+                run.items.push_back(std::move(item));
+            }
+        };
+        append(steamfeed::parseNewsItems(stub.respond(steamfeed::newsUrl(steamfeed::FirstPageCount)), gidRules()));
+
+        std::deque<PendingPage> pending;
+        steamfeed::FeedPager pager([&](const std::string& url) {
+            pending.push_back({ url, run.frames + LatencyFrames });
+        }, steamfeed::OlderPageCount);
+
+        float fromTop = 0;
+        for (; run.frames < MaxFrames; run.frames++) {
+            while (!pending.empty() && pending.front().dueFrame <= run.frames) {
+                auto url = std::move(pending.front().url);
+                pending.pop_front();
+
+                // the layer drops the articles at the page's end date, they're on screen already
+                std::unordered_set<std::string> boundary;
+                for (auto it = run.items.rbegin(); it != run.items.rend() && it->timestamp == run.items.back().timestamp; ++it) {
+                    boundary.insert(it->gid);
+                }
+                steamfeed::ParsedFeed parsed;
+                parsed.parse(stub.respond(url), gidRules());
+                std::vector<steamfeed::NewsItem> page;
+                for (const auto& item : parsed.items()) {
+                    if (!boundary.contains(std::string(item.gid))) {
+                        page.push_back(steamfeed::toNewsItem(item));
+                    }
+                }
+                pager.pageLoaded(url, parsed.received(), parsed.oldestReceived());
+                append(std::move(page));
+            }
+
+            float end = std::max(0.0f, list.totalHeight() - ViewHeight);
+            fromTop = std::min(fromTop + ScrollPerFrame, end);
+            if (list.totalHeight() - (fromTop + ViewHeight) < LoadOlderDistance) {
+                run.asks++;
+                if (!pager.requestOlder(run.items.back().timestamp) && pager.loading()) {
+                    run.suppressed++;
+                }
+            }
+            if (pager.exhausted() && pending.empty() && fromTop >= end) {
+                break;
+            }
+        }
+        return run;
+    }
+
+    // Pages whose articles were all dropped, reposts or the boundary, have to move the pager
+    // along rather than end the feed, which only a short page does
+    bool pagesMoveOn() {
+        std::string requested;
+        steamfeed::FeedPager pager([&](const std::string& url) { requested = url; }, steamfeed::OlderPageCount);
+        constexpr std::int64_t Oldest = 1700000000;
+
+        // a full page of reposts reaching back to Oldest - 500, none of it shown
+        pager.requestOlder(Oldest);
+        pager.pageLoaded(requested, steamfeed::OlderPageCount, Oldest - 500);
+        bool movedOn = !pager.exhausted() && pager.requestOlder(Oldest) && requested == steamfeed::newsUrl(steamfeed::OlderPageCount, Oldest - 500);
+        // a full page of one second's articles, the pager has to get past that second
+        pager.pageLoaded(requested, steamfeed::OlderPageCount, Oldest - 500);
+        bool skipped = pager.requestOlder(Oldest) && requested == steamfeed::newsUrl(steamfeed::OlderPageCount, Oldest - 501);
+        // and one short of the count is the end of the feed
+        pager.pageLoaded(requested, steamfeed::OlderPageCount - 1, Oldest - 900);
+        return movedOn && skipped && pager.exhausted() && !pager.requestOlder(Oldest);
+    }
+
+    // The reader holding the list at the bottom for a minute while every older page fails: how
+    // many requests the pager lets out, and whether a retry still gets one through at once
+    std::size_t failingRequests(bool& retried) {
+        using Clock = steamfeed::FeedPager::Clock;
+        constexpr auto Frame = std::chrono::microseconds(16667);
+        constexpr std::size_t Frames = 60 * 60;
+
+        std::size_t requests = 0;
+        std::deque<PendingPage> pending;
+        std::size_t frame = 0;
+        steamfeed::FeedPager pager([&](const std::string& url) {
+            requests++;
+            pending.push_back({ url, frame + LatencyFrames });
+        }, steamfeed::OlderPageCount);
+
+        auto start = Clock::now();
+        for (; frame < Frames; frame++) {
+            auto now = start + frame * Frame;
+            while (!pending.empty() && pending.front().dueFrame <= frame) {
+                pager.pageFailed(pending.front().url, now);
+                pending.pop_front();
+            }
+            pager.requestOlder(1, now);
+        }
+        auto now = start + frame * Frame;
+        while (!pending.empty()) {
+            pager.pageFailed(pending.front().url, now);
+            pending.pop_front();
+        }
+        pager.retry();
+        retried = pager.requestOlder(1, now);
+        return requests;
+    }
+}
+
+// Paging through the feed with enddate against a stub of the API: how much a cold start
+// downloads and parses with a first page instead of the full feed, and that flinging to the
+// bottom loads every article once, in order, without asking for a page twice at a time
+void runPagingBench(const Options& options, const std::vector<Payload>&) {
+    auto historySize = options.itemCount;
+    auto full = steamfeed::parseNewsItems(makeSyntheticFeed(historySize), gidRules());
+
+    NewsApiStub stub(historySize);
+    auto run = scrollToTheEnd(stub);
+    std::size_t outOfOrder = 0;
+    for (std::size_t i = 0; i < std::min(run.items.size(), full.size()); i++) {
+        outOfOrder += run.items[i].gid != full[i].gid;
+    }
+
+    std::printf("\n== paging: %zu article history, %d first, %d per older page\n", historySize, steamfeed::FirstPageCount, steamfeed::OlderPageCount);
+    std::printf("%zu of %zu articles loaded, %zu out of order, %zu requests, %zu of %zu asks dropped as in flight, %zu frames\n",
+        run.items.size(), full.size(), outOfOrder, stub.requests(), run.suppressed, run.asks, run.frames);
+
+    bool movesOn = pagesMoveOn();
+    std::printf("pages of only dropped articles %s\n", movesOn ? "move the pager along" : "DON'T move the pager along");
+    if (!movesOn || run.items.size() != full.size() || outOfOrder != 0) {
+        std::printf("FAILED: paging didn't load the whole feed in order\n");
+        markFailed();
+    }
+
+    bool retried = false;
+    auto failing = failingRequests(retried);
+    std::printf("a failing page held at the bottom for a minute: %zu requests, %s on retry\n", failing,
+        retried ? "one more" : "none");
+    // without the backoff it's one every round trip, a few hundred
+    if (failing > 10 || !retried) {
+        std::printf("FAILED: the pager doesn't back off a failing page\n");
+        markFailed();
+    }
+
+    auto firstPage = stub.respond(steamfeed::newsUrl(steamfeed::FirstPageCount));
+    auto fullFeed = stub.respond(steamfeed::newsUrl(static_cast<int>(historySize)));
+    reportHeader("paging: cold start, " + std::to_string(firstPage.size() / 1024) + " KB first page vs "
+        + std::to_string(fullFeed.size() / 1024) + " KB full feed");
+    std::size_t items = 0;
+    auto first = measure(options.iterations, [&] {
+        items = steamfeed::parseNewsItems(firstPage, gidRules()).size();
+    });
+    report("first-page", first, firstPage.size(), items);
+    auto all = measure(options.iterations, [&] {
+        items = steamfeed::parseNewsItems(fullFeed, gidRules()).size();
+    });
+    report("full-feed", all, fullFeed.size(), items);
+}
+
+}
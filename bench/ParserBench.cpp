@@ -0,0 +1,99 @@
+#include "Bench.hpp"
+#include "LegacyPipeline.hpp"
+#include "core/NewsParser.hpp"
+#include <cstdio>
+#include <string>
+
+namespace bench {
+
+namespace {
+    bool sameItems(const std::vector<steamfeed::NewsItem>& a, const std::vector<steamfeed::NewsItem>& b) {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); i++) {
+            if (a[i].gid != b[i].gid || a[i].title != b[i].title || a[i].content != b[i].content || a[i].date != b[i].date) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The skip rules from gid_rules.json against the old hard-coded set, over the feed's own
+    // gids plus every gid the set knows, looked up the way each version did it per article
+    void compareGidRules(const Options& options, const std::vector<steamfeed::NewsItem>& items) {
+        std::vector<std::string> gids = { "5410576585126249016", "5218041989051270041" };
+        for (const auto& item : items) {
+            gids.push_back(item.gid);
+        }
+        for (std::uint64_t gid : { 5410576585124650573ull, 2436926440562370340ull, 295352659733029280ull, 521624142113331755ull }) {
+            gids.push_back(std::to_string(gid));
+        }
+
+        int mismatches = 0;
+        for (const auto& gid : gids) {
+            bool skipped = legacy::isSkippedGid(gid) || gid == "5410576585126249016";
+            auto rules = gidRules().rules(gid);
+            bool stripped = gid == "5218041989051270041";
+            mismatches += skipped != ((rules & steamfeed::SkipArticle) != 0) || stripped != ((rules & steamfeed::StripSlashes) != 0);
+        }
+
+        reportHeader("gid rules: " + std::to_string(gids.size()) + " lookups, " + std::to_string(mismatches) + " mismatches");
+        if (mismatches != 0) {
+            markFailed();
+        }
+        std::size_t hits = 0;
+        auto set = measure(options.iterations, [&] {
+            hits = 0;
+            for (const auto& gid : gids) {
+                hits += legacy::isSkippedGid(gid);
+            }
+        });
+        report("std::set", set, 0, gids.size());
+
+        auto table = measure(options.iterations, [&] {
+            hits = 0;
+            for (const auto& gid : gids) {
+                hits += gidRules().rules(gid) & steamfeed::SkipArticle;
+            }
+        });
+        report("table", table, 0, gids.size());
+    }
+}
+
+// DOM parse vs the streaming SAX handler over the same payload. "sax-stream" hands
+// every item to a sink that drops it, which is the parser's own peak memory.
+void runParserBench(const Options& options, const std::vector<Payload>& payloads) {
+    for (const auto& payload : payloads) {
+        reportHeader("parser: " + payload.name);
+
+        std::vector<steamfeed::NewsItem> domItems;
+        auto dom = measure(options.iterations, [&] {
+            domItems = legacy::parseRawNewsItems(payload.body);
+        });
+        report("dom", dom, payload.body.size(), domItems.size());
+
+        std::vector<steamfeed::NewsItem> saxItems;
+        auto sax = measure(options.iterations, [&] {
+            saxItems = steamfeed::parseRawNewsItems(payload.body, gidRules());
+        });
+        report("sax", sax, payload.body.size(), saxItems.size());
+
+        std::size_t streamed = 0;
+        auto stream = measure(options.iterations, [&] {
+            streamed = 0;
+            steamfeed::parseRawNewsItems(payload.body.data(), payload.body.size(), gidRules(), [&](steamfeed::NewsItem&&) {
+                streamed++;
+                return true;
+            });
+        });
+        report("sax-stream", stream, payload.body.size(), streamed);
+
+        if (!sameItems(domItems, saxItems)) {
+            std::printf("MISMATCH: sax output differs from the dom parse\n");
+            markFailed();
+        }
+
+        compareGidRules(options, saxItems);
+    }
+}
+
+}
@@ -0,0 +1,51 @@
+#include "Bench.hpp"
+#include "core/NewsParser.hpp"
+#include "core/TextSanitizer.hpp"
+#include "core/TextWrap.hpp"
+
+namespace bench {
+
+namespace {
+    // goldFont at the title scale averages roughly 19 units per glyph
+    float approximateGoldWidth(std::string_view word) {
+        return static_cast<float>(word.size()) * 19.0f;
+    }
+}
+
+// parse -> sanitize -> wrap, the same stages the layer runs per refresh
+void runPipelineBench(const Options& options, const std::vector<Payload>& payloads) {
+    for (const auto& payload : payloads) {
+        reportHeader("pipeline: " + payload.name);
+
+        std::vector<steamfeed::NewsItem> items;
+        auto parse = measure(options.iterations, [&] {
+            items = steamfeed::parseRawNewsItems(payload.body, gidRules());
+        });
+        report("parse", parse, payload.body.size(), items.size());
+
+        std::size_t contentBytes = 0;
+        std::size_t titleBytes = 0;
+        for (const auto& item : items) {
+            contentBytes += item.content.size();
+            titleBytes += item.title.size();
+        }
+
+        std::vector<std::string> sanitized(items.size());
+        auto sanitize = measure(options.iterations, [&] {
+            for (std::size_t i = 0; i < items.size(); i++) {
+                sanitized[i] = steamfeed::removeUnwantedParts(items[i].content, items[i].rules);
+            }
+        });
+        report("sanitize", sanitize, contentBytes, items.size());
+
+        std::vector<std::string> wrapped(items.size());
+        auto wrap = measure(options.iterations, [&] {
+            for (std::size_t i = 0; i < items.size(); i++) {
+                wrapped[i] = steamfeed::wrapText(items[i].title, 400.0f, approximateGoldWidth);
+            }
+        });
+        report("wrap", wrap, titleBytes, items.size());
+    }
+}
+
+}
@@ -0,0 +1,117 @@
+#include "Bench.hpp"
+#include "core/FontMetrics.hpp"
+#include "core/NewsLayout.hpp"
+#include "core/NewsParser.hpp"
+#include <chrono>
+#include <cstdio>
+
+namespace bench {
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr float CellWidth = 419.0f;
+    constexpr float PixelsPerPoint = 4.0f;
+    // NewsCell's
+    constexpr std::uint32_t PreviewLines = 8;
+
+    steamfeed::NewsLayoutStyle cellStyle(const steamfeed::FontMetrics& metrics, std::uint32_t previewLines) {
+        steamfeed::LayoutFont font;
+        font.lineHeight = static_cast<float>(metrics.lineHeight()) / PixelsPerPoint;
+        font.measure = [&metrics](std::string_view word) { return metrics.measure(word) / PixelsPerPoint; };
+        font.scale = 0.8f;
+        steamfeed::NewsLayoutStyle style{ CellWidth, 40, font, font, font };
+        style.previewLines = previewLines;
+        return style;
+    }
+
+    std::size_t lineCount(const steamfeed::NewsLayout& layout) {
+        std::size_t lines = 0;
+        for (std::size_t i = 0; i < layout.size(); i++) {
+            lines += layout[i].titleLines + layout[i].contentLines;
+        }
+        return lines;
+    }
+
+    // Articles whose layout differs from the full one anywhere, lines included
+    std::size_t mismatches(const steamfeed::NewsLayout& layout, const steamfeed::NewsLayout& full) {
+        std::size_t count = layout.size() != full.size() || layout.totalHeight() != full.totalHeight();
+        for (std::size_t i = 0; i < std::min(layout.size(), full.size()); i++) {
+            auto lines = layout.contentLines(i);
+            auto fullLines = full.contentLines(i);
+            bool same = layout[i].height == full[i].height && layout.list().offset(i) == full.list().offset(i)
+                && lines.size() == fullLines.size();
+            for (std::size_t j = 0; same && j < lines.size(); j++) {
+                same = lines[j].begin == fullLines[j].begin && lines[j].end == fullLines[j].end;
+            }
+            count += !same;
+        }
+        return count;
+    }
+}
+
+// The feed's first layout with every article's full contents against previews of their first
+// few lines, then what expanding the longest one costs. Expanding all of them has to give
+// back the full layout exactly.
+void runPreviewBench(const Options& options, const std::vector<Payload>& payloads) {
+    steamfeed::FontMetrics metrics;
+    metrics.parse(syntheticFnt());
+    auto fullStyle = cellStyle(metrics, 0);
+    auto previewStyle = cellStyle(metrics, PreviewLines);
+
+    for (const auto& payload : payloads) {
+        auto items = steamfeed::parseNewsItems(payload.body, gidRules());
+        std::size_t contentBytes = 0;
+        std::size_t longest = 0;
+        for (std::size_t i = 0; i < items.size(); i++) {
+            contentBytes += items[i].content.size();
+            longest = items[i].content.size() > items[longest].content.size() ? i : longest;
+        }
+
+        steamfeed::NewsLayout full(fullStyle);
+        steamfeed::NewsLayout preview(previewStyle);
+        auto layoutAll = [&](steamfeed::NewsLayout& layout) {
+            layout.clear();
+            for (const auto& item : items) {
+                layout.append(item.title, item.content);
+            }
+        };
+        auto fullResult = measure(options.iterations, [&] { layoutAll(full); });
+        auto previewResult = measure(options.iterations, [&] { layoutAll(preview); });
+
+        std::size_t truncated = 0;
+        for (std::size_t i = 0; i < preview.size(); i++) {
+            truncated += preview[i].truncated;
+        }
+        reportHeader("preview: " + payload.name + ", " + std::to_string(truncated) + " of " + std::to_string(items.size())
+            + " articles cut to " + std::to_string(PreviewLines) + " lines");
+        report("full", fullResult, contentBytes, items.size());
+        report("preview", previewResult, contentBytes, items.size());
+        std::printf("%-16s %zu lines against %zu, %.0f points of list against %.0f\n", "",
+            lineCount(preview), lineCount(full), preview.totalHeight(), full.totalHeight());
+
+        // one article the way NewsFeed::expand does it, copy of the layout included
+        double expandSeconds = 1e30;
+        for (int i = 0; i < options.iterations; i++) {
+            auto start = Clock::now();
+            auto expanded = preview;
+            expanded.expand(longest, items[longest].title, items[longest].content);
+            expandSeconds = std::min(expandSeconds, std::chrono::duration<double>(Clock::now() - start).count());
+        }
+
+        auto expanded = preview;
+        for (std::size_t i = 0; i < expanded.size(); i++) {
+            if (expanded[i].truncated) {
+                expanded.expand(i, items[i].title, items[i].content);
+            }
+        }
+        auto expandedMismatches = mismatches(expanded, full);
+        std::printf("%-16s expanding the longest (%zu KB): %.3f ms, all expanded: %zu mismatches against full\n", "",
+            items[longest].content.size() / 1024, expandSeconds * 1e3, expandedMismatches);
+        if (expandedMismatches != 0) {
+            markFailed();
+        }
+    }
+}
+
+}
@@ -0,0 +1,99 @@
+#include "Bench.hpp"
+#include "LegacyPipeline.hpp"
+#include "core/NewsParser.hpp"
+#include "core/TextSanitizer.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <random>
+
+namespace bench {
+
+namespace {
+    constexpr std::size_t LongestPosts = 10;
+    constexpr int FuzzCases = 20000;
+
+    // BBCode pieces plus fragments of every marker, glued together with and without
+    // whitespace so erases join text into new markers the way real edits never would
+    const std::array<const char*, 34> s_fuzzTokens = {
+        "[url=https://store.steampowered.com/app/322170/]", "[/url]", "url=", "/url", "u", "ur", "url", "rl=", "l=",
+        "previewyoutube=", "[previewyoutube=k90y6PIzIaE;full]", "[/previewyoutube]", "preview", "youtube=",
+        "[list]", "[/list]", "/list", "/li", "st", "/l", "ist", "[*]", "[h1]", "[/h1]", "[", "]", "/",
+        "/Ru", "/Rub", "R", "Geometry", "Dash", "2.2", "{STEAM_CLAN_IMAGE}/7432088/x.png"
+    };
+    const std::array<const char*, 7> s_separators = { "", "", " ", "  ", "\n", "\t", " \n " };
+
+    std::string makeFuzzText(std::mt19937& rng) {
+        // leading plain word, a marker at the very start with no space after it hangs the reference
+        std::string text = "Start ";
+        int tokens = 1 + rng() % 24;
+        for (int i = 0; i < tokens; i++) {
+            text += s_fuzzTokens[rng() % s_fuzzTokens.size()];
+            text += s_separators[rng() % s_separators.size()];
+        }
+        return text;
+    }
+
+    int fuzzAgainstLegacy() {
+        std::mt19937 rng(6);
+        std::string out;
+        int mismatches = 0;
+        for (int i = 0; i < FuzzCases; i++) {
+            auto text = makeFuzzText(rng);
+            std::string gid = rng() % 4 == 0 ? "5218041989051270041" : "5124585319850001325";
+            auto expected = legacy::removeUnwantedParts(text, gid);
+            steamfeed::removeUnwantedParts(text, gidRules().rules(gid), out);
+            if (out != expected && mismatches++ < 5) {
+                std::printf("MISMATCH (gid %s)\n  input:    \"%s\"\n  legacy:   \"%s\"\n  sanitize: \"%s\"\n",
+                    gid.c_str(), text.c_str(), expected.c_str(), out.c_str());
+            }
+        }
+        return mismatches;
+    }
+}
+
+// Legacy find/erase sanitizer vs the single-pass one over the longest posts of the feed,
+// after checking that both agree on the real articles and on generated markup soup
+void runSanitizerBench(const Options& options, const std::vector<Payload>& payloads) {
+    int mismatches = fuzzAgainstLegacy();
+    std::printf("\n== sanitizer: %d fuzz cases, %d mismatches\n", FuzzCases, mismatches);
+    if (mismatches != 0) {
+        markFailed();
+    }
+
+    for (const auto& payload : payloads) {
+        auto items = steamfeed::parseRawNewsItems(payload.body, gidRules());
+        std::sort(items.begin(), items.end(), [](const auto& a, const auto& b) {
+            return a.content.size() > b.content.size();
+        });
+        items.resize(std::min(items.size(), LongestPosts));
+
+        std::size_t bytes = 0;
+        for (const auto& item : items) {
+            bytes += item.content.size();
+            if (legacy::removeUnwantedParts(item.content, item.gid) != steamfeed::removeUnwantedParts(item.content, item.rules)) {
+                std::printf("MISMATCH: article %s sanitizes differently\n", item.gid.c_str());
+                markFailed();
+            }
+        }
+
+        reportHeader("sanitizer: " + std::to_string(items.size()) + " longest posts of " + payload.name);
+        std::string sink;
+        auto before = measure(options.iterations, [&] {
+            for (const auto& item : items) {
+                sink = legacy::removeUnwantedParts(item.content, item.gid);
+            }
+        });
+        report("find-erase", before, bytes, items.size());
+
+        std::string out;
+        auto after = measure(options.iterations, [&] {
+            for (const auto& item : items) {
+                steamfeed::removeUnwantedParts(item.content, item.rules, out);
+            }
+        });
+        report("single-pass", after, bytes, items.size());
+    }
+}
+
+}
@@ -0,0 +1,99 @@
+#include "Bench.hpp"
+#include "SyntheticFeed.hpp"
+#include "core/FontMetrics.hpp"
+#include "core/NewsLayout.hpp"
+#include "core/NewsParser.hpp"
+#include "core/TaskPool.hpp"
+#include <cstdio>
+#include <string>
+#include <thread>
+
+namespace bench {
+
+namespace {
+    constexpr std::size_t FeedItems = 10000;
+    constexpr float CellWidth = 419.0f;
+    constexpr float PixelsPerPoint = 4.0f;
+
+    steamfeed::NewsLayoutStyle cellStyle(const steamfeed::FontMetrics& metrics) {
+        steamfeed::LayoutFont font;
+        font.lineHeight = static_cast<float>(metrics.lineHeight()) / PixelsPerPoint;
+        font.measure = [&metrics](std::string_view word) { return metrics.measure(word) / PixelsPerPoint; };
+        font.scale = 0.8f;
+        return { CellWidth, 40, font, font, font };
+    }
+
+    // Articles and layouts that differ anywhere, lines included
+    std::size_t mismatches(const steamfeed::ParsedFeed& feed, const steamfeed::NewsLayout& layout,
+        const steamfeed::ParsedFeed& expectedFeed, const steamfeed::NewsLayout& expectedLayout) {
+        std::size_t count = feed.size() != expectedFeed.size() || layout.size() != expectedLayout.size();
+        for (std::size_t i = 0; i < std::min(feed.size(), expectedFeed.size()) && i < layout.size(); i++) {
+            const auto& a = feed[i];
+            const auto& b = expectedFeed[i];
+            auto lines = layout.contentLines(i);
+            auto expectedLines = expectedLayout.contentLines(i);
+            bool same = a.gid == b.gid && a.content == b.content && a.date == b.date
+                && layout[i].height == expectedLayout[i].height && lines.size() == expectedLines.size();
+            for (std::size_t j = 0; same && j < lines.size(); j++) {
+                same = lines[j].begin == expectedLines[j].begin && lines[j].end == expectedLines[j].end;
+            }
+            count += !same;
+        }
+        return count;
+    }
+}
+
+// Parsing, sanitizing and laying out a long feed with the measuring spread over a TaskPool, as
+// the cache load does, against the one thread pipeline the worker streams with
+void runScalingBench(const Options& options, const std::vector<Payload>&) {
+    steamfeed::FontMetrics metrics;
+    metrics.parse(syntheticFnt());
+    auto style = cellStyle(metrics);
+    auto body = makeSyntheticFeed(FeedItems);
+
+    steamfeed::ParsedFeed expectedFeed;
+    steamfeed::NewsLayout expectedLayout(style);
+    expectedFeed.parse(body, gidRules(), [&](const steamfeed::NewsItemView& item) {
+        expectedLayout.append(item.title, item.content);
+        return true;
+    });
+
+    int iterations = std::max(1, options.iterations / 4);
+    reportHeader("scaling: synthetic x" + std::to_string(FeedItems) + ", " + std::to_string(body.size() / 1024)
+        + " KB response, " + std::to_string(std::thread::hardware_concurrency()) + " hardware threads");
+
+    std::vector<std::string> responses(iterations, body);
+    std::size_t next = 0;
+    auto serial = measure(iterations, [&] {
+        steamfeed::ParsedFeed feed;
+        steamfeed::NewsLayout layout(style);
+        feed.parse(std::move(responses[next++]), gidRules(), [&](const steamfeed::NewsItemView& item) {
+            layout.append(item.title, item.content);
+            return true;
+        });
+    });
+    report("serial", serial, body.size(), expectedFeed.size());
+
+    for (unsigned threads : { 1u, 2u, 4u, 8u }) {
+        steamfeed::TaskPool pool(threads);
+        steamfeed::ParsedFeed feed;
+        steamfeed::NewsLayout layout(style);
+        responses.assign(iterations, body);
+        next = 0;
+        auto result = measure(iterations, [&] {
+            feed = steamfeed::ParsedFeed();
+            layout = steamfeed::NewsLayout(style);
+            feed.parse(std::move(responses[next++]), gidRules());
+            layout.append(feed.items(), pool);
+        });
+        auto name = "pool x" + std::to_string(threads);
+        report(name.c_str(), result, body.size(), feed.size());
+        auto poolMismatches = mismatches(feed, layout, expectedFeed, expectedLayout);
+        std::printf("%-16s %.2fx the serial time, %zu mismatches\n", "", result.seconds / serial.seconds, poolMismatches);
+        if (poolMismatches != 0) {
+            markFailed();
+        }
+    }
+}
+
+}
@@ -0,0 +1,221 @@
+#include "Bench.hpp"
+#include "NewsStub.hpp"
+#include "core/FeedStore.hpp"
+#include "core/FontMetrics.hpp"
+#include "core/NewsApi.hpp"
+#include "core/NewsLayout.hpp"
+#include "core/NewsParser.hpp"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <unordered_set>
+
+namespace bench {
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Opens = 20;
+    constexpr float CellWidth = 419.0f;
+    constexpr float PixelsPerPoint = 4.0f;
+
+    steamfeed::NewsLayoutStyle cellStyle(const steamfeed::FontMetrics& metrics) {
+        steamfeed::LayoutFont font;
+        font.lineHeight = static_cast<float>(metrics.lineHeight()) / PixelsPerPoint;
+        font.measure = [&metrics](std::string_view word) { return metrics.measure(word) / PixelsPerPoint; };
+        font.scale = 0.8f;
+        return { CellWidth, 40, font, font, font };
+    }
+
+    struct Page {
+        std::vector<steamfeed::NewsItem> items;
+        steamfeed::NewsLayout layout;
+    };
+
+    // What the feed does with a response: parse, sanitize and lay it out
+    Page load(NewsApiStub& stub, const std::string& url, const steamfeed::NewsLayoutStyle& style) {
+        Page page;
+        page.layout = steamfeed::NewsLayout(style);
+        auto body = stub.respond(url);
+        steamfeed::parseNewsItems(body.data(), body.size(), gidRules(), [&](steamfeed::NewsItem&& item) {
+            page.layout.append(item.title, item.content);
+            page.items.push_back(std::move(item));
+            return true;
+        });
+        return page;
+    }
+
+    // A layer: whatever snapshot it was last handed
+    struct View {
+        steamfeed::FeedStore::Snapshot shown;
+        steamfeed::FeedStore::Subscription subscription = 0;
+    };
+
+    double since(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+}
+
+// Opening the layer again and again within the refresh interval: every layer fetching and
+// parsing the newest page for itself, against all of them subscribing to one FeedStore that
+// only the first open fills. Then what moving every open view on to the next snapshot costs
+// when a page of older articles comes in, against copying the articles into each view.
+void runServiceBench(const Options& options, const std::vector<Payload>&) {
+    auto historySize = options.itemCount;
+    steamfeed::FontMetrics metrics;
+    metrics.parse(syntheticFnt());
+    auto style = cellStyle(metrics);
+    auto firstUrl = steamfeed::newsUrl(steamfeed::FirstPageCount);
+
+    std::printf("\n== service: %d opens of the layer, %zu article history\n", Opens, historySize);
+    std::printf("%-12s %10s %10s %12s %10s\n", "mode", "requests", "KB", "ms/open", "snapshots");
+
+    {
+        NewsApiStub stub(historySize);
+        std::vector<Page> screens;
+        auto start = Clock::now();
+        for (int i = 0; i < Opens; i++) {
+            screens.push_back(load(stub, firstUrl, style));
+        }
+        double seconds = since(start);
+        std::printf("%-12s %10zu %10zu %12.3f %10d\n", "per-layer", stub.requests(), stub.bytesServed() / 1024,
+            seconds * 1e3 / Opens, Opens);
+    }
+
+    NewsApiStub stub(historySize);
+    steamfeed::FeedStore store;
+    std::vector<View> views(Opens);
+    auto start = Clock::now();
+    for (auto& view : views) {
+        view.subscription = store.subscribe([&view](const steamfeed::FeedStore::Snapshot& snapshot, steamfeed::FeedChange, std::size_t) {
+            view.shown = snapshot;
+        });
+        // the layer's refresh: only the first open finds the feed empty
+        if (store.empty()) {
+            auto page = load(stub, firstUrl, style);
+            store.replace(std::move(page.items), std::move(page.layout));
+        }
+        view.shown = store.snapshot();
+    }
+    double seconds = since(start);
+    std::unordered_set<const steamfeed::FeedSnapshot*> distinct;
+    for (const auto& view : views) {
+        distinct.insert(view.shown.get());
+    }
+    std::printf("%-12s %10zu %10zu %12.3f %10zu\n", "shared", stub.requests(), stub.bytesServed() / 1024,
+        seconds * 1e3 / Opens, distinct.size());
+
+    // paging the shared feed back to a full one, every open view following along
+    std::size_t pages = 0;
+    while (store.snapshot()->items.size() < historySize) {
+        auto page = load(stub, steamfeed::newsUrl(steamfeed::OlderPageCount, store.snapshot()->items.back().timestamp), style);
+        std::unordered_set<std::string_view> boundary;
+        for (auto it = store.snapshot()->items.rbegin(); it != store.snapshot()->items.rend() && it->timestamp == store.snapshot()->items.back().timestamp; ++it) {
+            boundary.insert(it->gid);
+        }
+        Page older;
+        older.layout = steamfeed::NewsLayout(style);
+        for (std::size_t i = 0; i < page.items.size(); i++) {
+            if (!boundary.contains(page.items[i].gid)) {
+                older.layout.append(page.layout, i);
+                older.items.push_back(std::move(page.items[i]));
+            }
+        }
+        if (older.items.empty()) {
+            break;
+        }
+        store.append(std::move(older.items), older.layout);
+        pages++;
+    }
+    std::size_t behind = 0;
+    for (const auto& view : views) {
+        behind += view.shown != store.snapshot();
+    }
+    std::printf("%zu older pages, %zu articles, %zu of %d views behind the store\n",
+        pages, store.snapshot()->items.size(), behind, Opens);
+
+    // refreshes bringing in one newer article at a time until every article paged in has fallen
+    // off the bottom, the pages they came in with have to go with them
+    auto paged = store.snapshot()->owners.size();
+    auto newest = store.snapshot()->items.front().timestamp;
+    for (std::size_t i = 0; i < historySize; i++) {
+        steamfeed::NewsItem item = steamfeed::toNewsItem(store.snapshot()->items.back());
+        item.gid = "refresh-" + std::to_string(i);
+        item.timestamp = newest + static_cast<std::int64_t>(i) + 1;
+        steamfeed::NewsLayout layout(style);
+        layout.append(item.title, item.content);
+        store.prepend({ std::move(item) }, layout, historySize);
+    }
+    std::printf("%zu owners after paging, %zu after %zu refreshes\n", paged, store.snapshot()->owners.size(), historySize);
+    if (store.snapshot()->owners.size() > historySize) {
+        std::printf("FAILED: the snapshot kept owners no article points into\n");
+        markFailed();
+    }
+
+    // the last page again, on top of everything before it
+    auto full = store.snapshot();
+    std::vector<steamfeed::NewsItem> lastPage;
+    steamfeed::NewsLayout lastLayout(style);
+    auto pageStart = full->items.size() - std::min<std::size_t>(full->items.size(), steamfeed::OlderPageCount);
+    std::vector<steamfeed::NewsItem> before;
+    steamfeed::NewsLayout beforeLayout(style);
+    for (std::size_t i = 0; i < full->items.size(); i++) {
+        if (i < pageStart) {
+            before.push_back(steamfeed::toNewsItem(full->items[i]));
+            beforeLayout.append(full->layout, i);
+        }
+        else {
+            lastPage.push_back(steamfeed::toNewsItem(full->items[i]));
+            lastLayout.append(full->layout, i);
+        }
+    }
+
+    std::size_t bytes = 0;
+    for (const auto& item : lastPage) {
+        bytes += item.content.size();
+    }
+    reportHeader("service: " + std::to_string(lastPage.size()) + " older articles onto " + std::to_string(before.size())
+        + ", " + std::to_string(Opens) + " views");
+    // a store per iteration with the views subscribed, so only the append itself is measured
+    struct Followed {
+        steamfeed::FeedStore store;
+        std::vector<View> views = std::vector<View>(Opens);
+    };
+    std::vector<std::unique_ptr<Followed>> followed;
+    for (int i = 0; i < options.iterations; i++) {
+        auto& next = *followed.emplace_back(std::make_unique<Followed>());
+        next.store.replace(before, beforeLayout);
+        for (auto& view : next.views) {
+            view.shown = next.store.snapshot();
+            view.subscription = next.store.subscribe([&view](const steamfeed::FeedStore::Snapshot& snapshot, steamfeed::FeedChange, std::size_t) {
+                view.shown = snapshot;
+            });
+        }
+    }
+
+    auto baseSnapshot = followed.front()->store.snapshot();
+    auto copies = measure(options.iterations, [&] {
+        // every layer keeping its own articles, as each used to
+        for (int i = 0; i < Opens; i++) {
+            std::vector<steamfeed::NewsItem> items;
+            items.reserve(baseSnapshot->items.size() + lastPage.size());
+            for (const auto& item : baseSnapshot->items) {
+                items.push_back(steamfeed::toNewsItem(item));
+            }
+            items.insert(items.end(), lastPage.begin(), lastPage.end());
+            steamfeed::NewsLayout layout = baseSnapshot->layout;
+            for (std::size_t j = 0; j < lastPage.size(); j++) {
+                layout.append(lastLayout, j);
+            }
+        }
+    });
+    report("view-copies", copies, bytes, lastPage.size());
+
+    std::size_t next = 0;
+    auto shared = measure(options.iterations, [&] {
+        followed[next++]->store.append(lastPage, lastLayout);
+    });
+    report("snapshot", shared, bytes, lastPage.size());
+}
+
+}
@@ -0,0 +1,96 @@
+#include "Bench.hpp"
+#include "core/FontMetrics.hpp"
+#include "core/NewsLayout.hpp"
+#include "core/NewsParser.hpp"
+#include <cstdio>
+
+namespace bench {
+
+namespace {
+    constexpr float CellWidth = 419.0f;
+    constexpr float PixelsPerPoint = 4.0f;
+
+    // CCLabelBMFont keeps a sprite and a quad for every character but the line breaks
+    std::size_t glyphCount(std::string_view text) {
+        std::size_t glyphs = 0;
+        for (char c : text) {
+            bool continuation = (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+            glyphs += !continuation && c != '\n';
+        }
+        return glyphs;
+    }
+
+    struct FrameCost {
+        std::size_t nodes = 0;       // in the scene graph, visited every frame
+        std::size_t quads = 0;       // kept in the labels' buffers
+        std::size_t drawCalls = 0;
+        std::size_t vertices = 0;    // sent through the vertex shader
+
+        // A label is a sprite batch: the node, a sprite per glyph and one drawQuads, which the
+        // batch skips when it holds no quads. ShadowLabel draws its glyphs and their shadows
+        // out of one combined buffer, on top of the glyph sprites' own.
+        void addLabel(std::size_t glyphs, bool combined) {
+            std::size_t labels = combined ? 1 : 2;
+            nodes += labels * (1 + glyphs);
+            quads += combined ? 3 * glyphs : 2 * glyphs;
+            drawCalls += glyphs > 0 ? labels : 0;
+            vertices += 2 * 4 * glyphs;
+        }
+    };
+
+    void printCost(const char* mode, const FrameCost& cost) {
+        std::printf("%-14s %10zu %12zu %12zu %12zu\n", mode, cost.nodes, cost.quads, cost.drawCalls, cost.vertices);
+    }
+}
+
+// What drawing every cell of a feed costs per frame with a second label per shadow against
+// ShadowLabel's combined buffer. Counted from the label strings the layout produces, since
+// there's no GL context here to count on. Every glyph is still drawn twice, so the vertices
+// come out the same, while the nodes and draw calls halve.
+void runShadowBench(const Options& options, const std::vector<Payload>& payloads) {
+    steamfeed::FontMetrics metrics;
+    if (options.fontFiles.empty() || !metrics.loadFile(options.fontFiles.front())) {
+        metrics.parse(syntheticFnt());
+    }
+    steamfeed::LayoutFont font;
+    font.lineHeight = static_cast<float>(metrics.lineHeight()) / PixelsPerPoint;
+    font.measure = [&metrics](std::string_view word) { return metrics.measure(word) / PixelsPerPoint; };
+    font.scale = 0.8f;
+
+    for (const auto& payload : payloads) {
+        auto items = steamfeed::parseNewsItems(payload.body, gidRules());
+        steamfeed::NewsLayout layout({ CellWidth, 40, font, font, font });
+
+        std::size_t glyphs = 0;
+        FrameCost pairs;
+        FrameCost shadowed;
+        auto addLabel = [&](std::string_view label) {
+            auto labelGlyphs = glyphCount(label);
+            glyphs += labelGlyphs;
+            pairs.addLabel(labelGlyphs, false);
+            shadowed.addLabel(labelGlyphs, true);
+        };
+
+        std::string text;
+        for (std::size_t i = 0; i < items.size(); i++) {
+            layout.append(items[i].title, items[i].content);
+            // the cell itself
+            pairs.nodes++;
+            shadowed.nodes++;
+            steamfeed::NewsLayout::joinLines(items[i].title, layout.titleLines(i), text);
+            addLabel(text);
+            addLabel(items[i].date);
+            steamfeed::NewsLayout::joinLines(items[i].content, layout.contentLines(i), text);
+            addLabel(text);
+        }
+
+        std::printf("\n== shadows: %s, every one of %zu cells drawn, %zu glyphs of text\n", payload.name.c_str(), items.size(), glyphs);
+        std::printf("%-14s %10s %12s %12s %12s\n", "mode", "nodes", "quads kept", "draw calls", "vertices");
+        printCost("label-pairs", pairs);
+        printCost("shadow-label", shadowed);
+        std::printf("the shadow label drops %zu nodes and %zu draw calls, for %zu more quads kept\n", pairs.nodes - shadowed.nodes,
+            pairs.drawCalls - shadowed.drawCalls, shadowed.quads - pairs.quads);
+    }
+}
+
+}
@@ -0,0 +1,105 @@
+#include "SyntheticFeed.hpp"
+#include <array>
+#include <random>
+
+namespace bench {
+
+namespace {
+    const std::array<const char*, 24> s_words = {
+        "Geometry", "Dash", "update", "level", "editor", "new", "the", "and",
+        "players", "RobTop", "fixed", "bug", "online", "levels", "gauntlet", "icons",
+        "soon", "features", "with", "for", "speed", "portal", "practice", "mode"
+    };
+
+    const std::array<const char*, 10> s_markup = {
+        "[url=https://store.steampowered.com/app/322170/]Geometry Dash[/url]",
+        "[previewyoutube=k90y6PIzIaE;full][/previewyoutube]",
+        "[img]{STEAM_CLAN_IMAGE}/7432088/4fcada2e76dd5b2839d84e420a53315d8e078f98.png[/img]",
+        "[list][*]Added new icons[*]Fixed a crash in the editor[/list]",
+        "[b]Important[/b]",
+        "[i]Note:[/i]",
+        "[url=https://www.robtopgames.com]robtopgames.com[/url]",
+        "/Rub",
+        "[u]Update 2.2[/u]",
+        "\"Quoted\" text"
+    };
+
+    void appendEscaped(std::string& out, const std::string& text) {
+        for (char c : text) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                default: out += c; break;
+            }
+        }
+    }
+
+    std::string makeSentence(std::mt19937& rng, int words) {
+        std::string sentence;
+        for (int i = 0; i < words; i++) {
+            if (i > 0) sentence += ' ';
+            sentence += s_words[rng() % s_words.size()];
+        }
+        return sentence;
+    }
+
+    std::string makeContents(std::mt19937& rng) {
+        // most posts are short announcements, roughly one in ten is a long patch-notes post
+        bool patchNotes = rng() % 10 == 0;
+        int paragraphs = patchNotes ? 80 + rng() % 120 : 2 + rng() % 8;
+
+        // always leads with plain text, a leading "url=" with no space after it hangs the old sanitizer
+        std::string contents = "Hello everyone";
+        for (int i = 0; i < paragraphs; i++) {
+            contents += i % 4 == 0 ? "\n[h1]" + makeSentence(rng, 3) + "[/h1]\n" : "\n";
+            contents += makeSentence(rng, 6 + rng() % 30);
+            if (rng() % 3 == 0) {
+                contents += ' ';
+                contents += s_markup[rng() % s_markup.size()];
+            }
+            contents += ' ';
+            contents += makeSentence(rng, 4 + rng() % 12);
+            contents += '.';
+        }
+        return contents;
+    }
+}
+
+std::string makeSyntheticFeed(std::size_t itemCount, std::uint32_t seed) {
+    return makeSyntheticPage(itemCount, itemCount, 0, seed);
+}
+
+std::string makeSyntheticPage(std::size_t historySize, std::size_t count, std::int64_t endDate, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::string json = "{\"appnews\":{\"appid\":322170,\"newsitems\":[";
+
+    // the whole history is generated either way, so every article comes out the same on every page
+    std::int64_t date = 1700000000;
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < historySize && written < count; i++) {
+        std::string gid = std::to_string(5000000000000000000ull + static_cast<std::uint64_t>(rng()) * 1000 + i);
+        std::string title = makeSentence(rng, 3 + rng() % 10);
+        std::string contents = makeContents(rng);
+        std::int64_t itemDate = date;
+        date -= 3600 * (6 + rng() % 400);
+        if (endDate > 0 && itemDate > endDate) {
+            continue;
+        }
+
+        if (written++ > 0) json += ',';
+        json += "{\"gid\":\"" + gid + "\",\"title\":\"";
+        appendEscaped(json, title);
+        json += "\",\"url\":\"https://steamstore-a.akamaihd.net/news/externalpost/steam_community_announcements/" + gid + "\"";
+        json += ",\"is_external_url\":true,\"author\":\"RobTop\",\"contents\":\"";
+        appendEscaped(json, contents);
+        json += "\",\"feedlabel\":\"Community Announcements\",\"date\":" + std::to_string(itemDate);
+        json += ",\"feedname\":\"steam_community_announcements\",\"feed_type\":1,\"appid\":322170";
+        json += ",\"tags\":[\"patchnotes\"]}";
+    }
+
+    json += "],\"count\":" + std::to_string(historySize) + "}}";
+    return json;
+}
+
+}
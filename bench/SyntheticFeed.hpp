@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace bench {
+
+// Builds a GetNewsForApp v2 response shaped like Steam's, with BBCode-heavy
+// contents and the occasional very long patch-notes post
+std::string makeSyntheticFeed(std::size_t itemCount, std::uint32_t seed = 322170);
+
+// A page of the same feed the way the API's count and enddate pick it: the first count
+// articles of a historySize long history dated endDate or before (0 for no limit)
+std::string makeSyntheticPage(std::size_t historySize, std::size_t count, std::int64_t endDate, std::uint32_t seed = 322170);
+
+}
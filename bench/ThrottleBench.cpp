@@ -0,0 +1,144 @@
+#include "Bench.hpp"
+#include "core/FeedWorker.hpp"
+#include "core/FontMetrics.hpp"
+#include "core/NewsLayout.hpp"
+#include "core/NewsParser.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace bench {
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int PrefetchJobs = 8;
+    constexpr int LevelLoadParses = 40;
+    constexpr float CellWidth = 419.0f;
+    constexpr float PixelsPerPoint = 4.0f;
+
+    steamfeed::NewsLayoutStyle cellStyle(const steamfeed::FontMetrics& metrics) {
+        steamfeed::LayoutFont font;
+        font.lineHeight = static_cast<float>(metrics.lineHeight()) / PixelsPerPoint;
+        font.measure = [&metrics](std::string_view word) { return metrics.measure(word) / PixelsPerPoint; };
+        font.scale = 0.8f;
+        return { CellWidth, 40, font, font, font };
+    }
+
+    double since(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    struct ThrottleRun {
+        double levelLoad = 0;   // seconds the main thread took for the level
+        int jobsDuringLoad = 0; // prefetch jobs that started while it did
+        double prefetched = 0;  // seconds from the level being done to the prefetch being done
+    };
+
+    // Prefetch jobs are queued as a level starts loading. The level's load is stood in for by
+    // parsing on the main thread, CPU bound like the real one.
+    ThrottleRun loadLevel(const std::string& body, const steamfeed::NewsLayoutStyle& style, bool throttle) {
+        steamfeed::FeedWorker worker;
+        std::atomic<bool> loading{true};
+        std::atomic<int> jobsDuringLoad{0};
+        int completed = 0;
+        for (int i = 0; i < PrefetchJobs; i++) {
+            worker.post([&] {
+                jobsDuringLoad += loading.load();
+                steamfeed::NewsLayout layout(style);
+                steamfeed::parseNewsItems(body.data(), body.size(), gidRules(), [&](steamfeed::NewsItem&& item) {
+                    layout.append(item.title, item.content);
+                    return true;
+                });
+            }, [&] { completed++; });
+        }
+
+        ThrottleRun run;
+        auto start = Clock::now();
+        // the feed notices the level on its next frame, by then the first job may be running
+        if (throttle) {
+            worker.setPaused(true);
+        }
+        std::size_t items = 0;
+        for (int i = 0; i < LevelLoadParses; i++) {
+            items += steamfeed::parseRawNewsItems(body, gidRules()).size();
+        }
+        loading = false;
+        run.levelLoad = since(start);
+        run.jobsDuringLoad = jobsDuringLoad;
+
+        auto resumed = Clock::now();
+        worker.setPaused(false);
+        while (completed < PrefetchJobs) {
+            worker.poll();
+            std::this_thread::yield();
+        }
+        run.prefetched = since(resumed);
+        return run;
+    }
+
+    // Without off-thread layout the jobs run on the main thread instead, posted on poll. Frames
+    // polled while the worker is paused for a level must not run any of them, and after it
+    // one runs a frame, in order.
+    bool mainThreadJobsWait() {
+        steamfeed::FeedWorker worker;
+        std::vector<int> ran;
+        int completed = 0;
+        worker.setPaused(true);
+        for (int i = 0; i < PrefetchJobs; i++) {
+            worker.postOnPoll([&ran, i] { ran.push_back(i); }, [&] { completed++; });
+        }
+        for (int frame = 0; frame < 10; frame++) {
+            worker.poll();
+        }
+        bool waited = ran.empty() && !worker.idle();
+
+        worker.setPaused(false);
+        bool oneAFrame = true;
+        for (int frame = 0; frame < PrefetchJobs; frame++) {
+            worker.poll();
+            oneAFrame &= ran.size() == static_cast<std::size_t>(frame + 1);
+        }
+        worker.poll();
+        bool inOrder = std::is_sorted(ran.begin(), ran.end()) && ran.size() == PrefetchJobs;
+        return waited && oneAFrame && inOrder && completed == PrefetchJobs && worker.idle();
+    }
+}
+
+// What a background prefetch costs a level that starts loading while it's under way, with the
+// worker carrying on and with it paused for the level the way NewsFeed throttles it
+void runThrottleBench(const Options& options, const std::vector<Payload>& payloads) {
+    steamfeed::FontMetrics metrics;
+    metrics.parse(syntheticFnt());
+    auto style = cellStyle(metrics);
+
+    for (const auto& payload : payloads) {
+        std::printf("\n== throttle: %d prefetch jobs of %s during a level load, %u hardware threads\n",
+            PrefetchJobs, payload.name.c_str(), std::thread::hardware_concurrency());
+        std::printf("%-12s %14s %14s %14s\n", "mode", "level ms", "jobs started", "prefetch ms");
+        for (bool throttle : { false, true }) {
+            ThrottleRun best;
+            best.levelLoad = 1e30;
+            for (int i = 0; i < std::max(1, options.iterations / 4); i++) {
+                auto run = loadLevel(payload.body, style, throttle);
+                if (run.levelLoad < best.levelLoad) {
+                    best = run;
+                }
+            }
+            std::printf("%-12s %14.2f %14d %14.2f\n", throttle ? "throttled" : "unthrottled",
+                best.levelLoad * 1e3, best.jobsDuringLoad, best.prefetched * 1e3);
+        }
+    }
+
+    bool waits = mainThreadJobsWait();
+    std::printf("main thread jobs %s the level\n", waits ? "wait for" : "DON'T wait for");
+    if (!waits) {
+        std::printf("FAILED: main thread jobs ran while the worker was paused for a level\n");
+        markFailed();
+    }
+}
+
+}
@@ -0,0 +1,128 @@
+#include "Bench.hpp"
+#include "core/NewsParser.hpp"
+#include "core/VirtualList.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+namespace bench {
+
+namespace {
+    // the layer's cell width and chatFont at 0.8, near enough for the heights
+    constexpr float CellWidth = 419.0f;
+    constexpr float GlyphWidth = 7.0f;
+    constexpr float LineHeight = 20.0f;
+    constexpr float ViewHeight = 320.0f;
+    constexpr float VisibleMargin = 200.0f;
+    constexpr float ScrollStep = 7.0f;
+    // the cell node plus its three labels
+    constexpr std::size_t NodesPerCell = 4;
+
+    float estimateHeight(const steamfeed::NewsItem& item) {
+        float lines = std::ceil(static_cast<float>(item.content.size()) * GlyphWidth / CellWidth);
+        return 50 + lines * LineHeight;
+    }
+
+    // glyph sprites a cell holds
+    std::size_t glyphsOf(const steamfeed::NewsItem& item) {
+        return item.title.size() + item.date.size() + item.content.size();
+    }
+
+    struct ScrollStats {
+        std::size_t frames = 0;
+        std::size_t created = 0;  // the pool was empty
+        std::size_t rebound = 0;  // a pooled cell took a new article
+        std::size_t peakCells = 0;
+        std::size_t peakGlyphs = 0;
+    };
+
+    // The layer's updateVisibleCells, with the cells reduced to the article they show
+    class CellSimulation {
+    public:
+        CellSimulation(const steamfeed::VirtualList& list, const std::vector<steamfeed::NewsItem>& items)
+            : m_list(list), m_items(items) {}
+
+        void scrollTo(float fromTop) {
+            auto visible = m_list.visibleRange(fromTop, fromTop + ViewHeight, VisibleMargin);
+            for (auto it = m_visible.begin(); it != m_visible.end();) {
+                if (visible.contains(it->first)) {
+                    ++it;
+                    continue;
+                }
+                m_glyphs -= glyphsOf(m_items[it->first]);
+                m_pool++;
+                it = m_visible.erase(it);
+            }
+            for (auto index = visible.first; index < visible.last; index++) {
+                if (m_visible.contains(index)) {
+                    continue;
+                }
+                if (m_pool > 0) {
+                    m_pool--;
+                    stats.rebound++;
+                }
+                else {
+                    stats.created++;
+                }
+                m_visible.emplace(index, true);
+                m_glyphs += glyphsOf(m_items[index]);
+            }
+            stats.frames++;
+            stats.peakCells = std::max(stats.peakCells, m_visible.size() + m_pool);
+            stats.peakGlyphs = std::max(stats.peakGlyphs, m_glyphs);
+        }
+
+        ScrollStats stats;
+
+    private:
+        const steamfeed::VirtualList& m_list;
+        const std::vector<steamfeed::NewsItem>& m_items;
+        std::unordered_map<std::size_t, bool> m_visible;
+        std::size_t m_pool = 0;
+        std::size_t m_glyphs = 0;
+    };
+
+    ScrollStats scrollThrough(const steamfeed::VirtualList& list, const std::vector<steamfeed::NewsItem>& items) {
+        // top to bottom and back, one step per frame, like dragging through the whole feed
+        CellSimulation simulation(list, items);
+        float end = std::max(0.0f, list.totalHeight() - ViewHeight);
+        for (float fromTop = 0; fromTop < end; fromTop += ScrollStep) {
+            simulation.scrollTo(fromTop);
+        }
+        for (float fromTop = end; fromTop > 0; fromTop -= ScrollStep) {
+            simulation.scrollTo(fromTop);
+        }
+        return simulation.stats;
+    }
+}
+
+// Node and glyph counts of building every article up front vs only the cells in view with a
+// recycling pool, and the cost of keeping the window up to date per scroll frame
+void runVirtualListBench(const Options& options, const std::vector<Payload>& payloads) {
+    for (const auto& payload : payloads) {
+        auto items = steamfeed::parseNewsItems(payload.body, gidRules());
+
+        steamfeed::VirtualList list;
+        std::size_t allGlyphs = 0;
+        for (const auto& item : items) {
+            list.append(estimateHeight(item), 40);
+            allGlyphs += glyphsOf(item);
+        }
+
+        auto stats = scrollThrough(list, items);
+        std::printf("\n== virtual: %s, %zu articles over %.0f units\n", payload.name.c_str(), items.size(), list.totalHeight());
+        std::printf("%-12s %10s %12s %12s %12s\n", "mode", "nodes", "glyphs", "created", "rebound");
+        std::printf("%-12s %10zu %12zu %12zu %12s\n", "all-upfront", items.size() * NodesPerCell, allGlyphs, items.size(), "-");
+        std::printf("%-12s %10zu %12zu %12zu %12zu\n", "virtual", (stats.peakCells + 1) * NodesPerCell, stats.peakGlyphs, stats.created, stats.rebound);
+
+        reportHeader("virtual: " + std::to_string(stats.frames) + " scroll frames");
+        auto scroll = measure(options.iterations, [&] {
+            scrollThrough(list, items);
+        });
+        report("scroll", scroll, 0, stats.frames);
+    }
+}
+
+}
@@ -0,0 +1,125 @@
+#include "Bench.hpp"
+#include "core/FeedWorker.hpp"
+#include "core/FontMetrics.hpp"
+#include "core/NewsLayout.hpp"
+#include "core/NewsParser.hpp"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+namespace bench {
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr float CellWidth = 419.0f;
+    constexpr float PixelsPerPoint = 4.0f;
+    // a 320 point window plus the layer's margin
+    constexpr float FirstScreenHeight = 520.0f;
+
+    steamfeed::NewsLayoutStyle cellStyle(const steamfeed::FontMetrics& metrics) {
+        steamfeed::LayoutFont font;
+        font.lineHeight = static_cast<float>(metrics.lineHeight()) / PixelsPerPoint;
+        font.measure = [&metrics](std::string_view word) { return metrics.measure(word) / PixelsPerPoint; };
+        font.scale = 0.8f;
+        return { CellWidth, 40, font, font, font };
+    }
+
+    struct PreparedFeed {
+        std::vector<steamfeed::NewsItem> items;
+        steamfeed::NewsLayout layout;
+    };
+
+    // The worker's half of the layer's load
+    void prepare(PreparedFeed& prepared, const std::string& body, const steamfeed::NewsLayoutStyle& style) {
+        prepared.items = steamfeed::parseNewsItems(body, gidRules());
+        prepared.layout = steamfeed::NewsLayout(style);
+        for (const auto& item : prepared.items) {
+            prepared.layout.append(item.title, item.content);
+        }
+    }
+
+    // The main thread's half: taking the articles over and copying their layout into the screen's
+    void commit(PreparedFeed& prepared, std::vector<steamfeed::NewsItem>& items, steamfeed::NewsLayout& layout) {
+        items = std::move(prepared.items);
+        layout.clear();
+        for (std::size_t i = 0; i < items.size(); i++) {
+            layout.append(prepared.layout, i);
+        }
+    }
+
+    double since(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+}
+
+// How long a feed load holds up the main thread: everything on it as the layer used to do,
+// against parsing, sanitizing and layout on a FeedWorker with only the commit left for
+// the main thread, which keeps polling like the layer does once a frame. Then how soon
+// the first screenful is ready when the feed is streamed newest first.
+void runWorkerBench(const Options& options, const std::vector<Payload>& payloads) {
+    steamfeed::FontMetrics metrics;
+    if (options.fontFiles.empty() || !metrics.loadFile(options.fontFiles.front())) {
+        metrics.parse(syntheticFnt());
+    }
+    auto style = cellStyle(metrics);
+
+    for (const auto& payload : payloads) {
+        std::vector<steamfeed::NewsItem> items;
+        steamfeed::NewsLayout layout(style);
+
+        reportHeader("worker: " + payload.name + ", main thread time per load");
+        auto inlineLoad = measure(options.iterations, [&] {
+            PreparedFeed prepared;
+            prepare(prepared, payload.body, style);
+            commit(prepared, items, layout);
+        });
+        report("main-only", inlineLoad, payload.body.size(), items.size());
+
+        steamfeed::FeedWorker worker;
+        double mainSeconds = 1e30;
+        double readySeconds = 1e30;
+        std::size_t polls = 0;
+        auto staged = measure(options.iterations, [&] {
+            auto prepared = std::make_shared<PreparedFeed>();
+            bool ready = false;
+            double onMain = 0;
+            auto start = Clock::now();
+            worker.post([&, prepared] { prepare(*prepared, payload.body, style); }, [&, prepared] {
+                commit(*prepared, items, layout);
+                ready = true;
+            });
+            while (!ready) {
+                auto frame = Clock::now();
+                worker.poll();
+                onMain += since(frame);
+                polls++;
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+            mainSeconds = std::min(mainSeconds, onMain);
+            readySeconds = std::min(readySeconds, since(start));
+        });
+        StageResult mainThread = staged;
+        mainThread.seconds = mainSeconds;
+        report("worker-main", mainThread, payload.body.size(), items.size());
+
+        // the layer streams a cold feed, the first screenful goes up before the rest is parsed
+        std::size_t firstScreenItems = 0;
+        auto firstScreen = measure(options.iterations, [&] {
+            steamfeed::NewsLayout screen(style);
+            steamfeed::parseNewsItems(payload.body.data(), payload.body.size(), gidRules(), [&](steamfeed::NewsItem&& item) {
+                screen.append(item.title, item.content);
+                return screen.totalHeight() < FirstScreenHeight;
+            });
+            firstScreenItems = screen.size();
+        });
+        report("first-screen", firstScreen, payload.body.size(), firstScreenItems);
+
+        std::printf("%.3f ms until the layout is ready with the worker, %.3f ms of it on the main thread, %zu polls\n",
+            readySeconds * 1e3, mainSeconds * 1e3, polls);
+        std::printf("%.3f ms until the first %zu articles are laid out when streaming\n", firstScreen.seconds * 1e3, firstScreenItems);
+    }
+}
+
+}
@@ -0,0 +1,180 @@
+#include "Bench.hpp"
+#include "SyntheticFeed.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace bench {
+
+void runPipelineBench(const Options& options, const std::vector<Payload>& payloads);
+void runParserBench(const Options& options, const std::vector<Payload>& payloads);
+void runCacheBench(const Options& options, const std::vector<Payload>& payloads);
+void runSanitizerBench(const Options& options, const std::vector<Payload>& payloads);
+void runDedupBench(const Options& options, const std::vector<Payload>& payloads);
+void runFontBench(const Options& options, const std::vector<Payload>& payloads);
+void runVirtualListBench(const Options& options, const std::vector<Payload>& payloads);
+void runLayoutBench(const Options& options, const std::vector<Payload>& payloads);
+void runShadowBench(const Options& options, const std::vector<Payload>& payloads);
+void runWorkerBench(const Options& options, const std::vector<Payload>& payloads);
+void runPagingBench(const Options& options, const std::vector<Payload>& payloads);
+void runLifetimeBench(const Options& options, const std::vector<Payload>& payloads);
+void runServiceBench(const Options& options, const std::vector<Payload>& payloads);
+void runThrottleBench(const Options& options, const std::vector<Payload>& payloads);
+void runConditionalBench(const Options& options, const std::vector<Payload>& payloads);
+void runInSituBench(const Options& options, const std::vector<Payload>& payloads);
+void runArenaBench(const Options& options, const std::vector<Payload>& payloads);
+void runScalingBench(const Options& options, const std::vector<Payload>& payloads);
+void runDateBench(const Options& options, const std::vector<Payload>& payloads);
+void runPreviewBench(const Options& options, const std::vector<Payload>& payloads);
+
+const steamfeed::GidRuleTable& gidRules() {
+    static const steamfeed::GidRuleTable rules = [] {
+        steamfeed::GidRuleTable table;
+        if (!table.loadFile(STEAMFEED_ASSETS_DIR "/gid_rules.json")) {
+            std::fprintf(stderr, "steamfeed_bench: cannot load %s/gid_rules.json\n", STEAMFEED_ASSETS_DIR);
+        }
+        return table;
+    }();
+    return rules;
+}
+
+std::vector<Payload> loadPayloads(const Options& options) {
+    std::vector<Payload> payloads;
+    for (const auto& path : options.payloadFiles) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "steamfeed_bench: cannot open %s\n", path.c_str());
+            continue;
+        }
+        std::stringstream contents;
+        contents << file.rdbuf();
+        payloads.push_back({ path, contents.str() });
+    }
+
+    if (options.payloadFiles.empty()) {
+        payloads.push_back({ "synthetic x" + std::to_string(options.itemCount), makeSyntheticFeed(options.itemCount) });
+    }
+    return payloads;
+}
+
+namespace {
+    bool s_failed = false;
+}
+
+void markFailed() {
+    s_failed = true;
+}
+
+void reportHeader(const std::string& title) {
+    std::printf("\n== %s\n", title.c_str());
+    std::printf("%-12s %10s %10s %12s %12s %12s %10s\n", "stage", "ms", "MB/s", "items/s", "allocs/item", "bytes/item", "peak KB");
+}
+
+void report(const char* stage, const StageResult& result, std::size_t bytes, std::size_t items) {
+    double perItem = items ? 1.0 / static_cast<double>(items) : 0.0;
+    std::printf("%-12s %10.3f %10.1f %12.0f %12.2f %12.0f %10.1f\n",
+        stage,
+        result.seconds * 1e3,
+        static_cast<double>(bytes) / result.seconds / 1e6,
+        static_cast<double>(items) / result.seconds,
+        static_cast<double>(result.allocs) * perItem,
+        static_cast<double>(result.allocBytes) * perItem,
+        static_cast<double>(result.peakBytes) / 1024.0
+    );
+}
+
+}
+
+namespace {
+    struct Scenario {
+        const char* name;
+        void (*run)(const bench::Options&, const std::vector<bench::Payload>&);
+    };
+
+    const Scenario s_scenarios[] = {
+        { "pipeline", bench::runPipelineBench },
+        { "parser", bench::runParserBench },
+        { "cache", bench::runCacheBench },
+        { "sanitizer", bench::runSanitizerBench },
+        { "dedup", bench::runDedupBench },
+        { "fonts", bench::runFontBench },
+        { "virtual", bench::runVirtualListBench },
+        { "layout", bench::runLayoutBench },
+        { "shadows", bench::runShadowBench },
+        { "worker", bench::runWorkerBench },
+        { "paging", bench::runPagingBench },
+        { "lifetime", bench::runLifetimeBench },
+        { "service", bench::runServiceBench },
+        { "throttle", bench::runThrottleBench },
+        { "conditional", bench::runConditionalBench },
+        { "insitu", bench::runInSituBench },
+        { "arena", bench::runArenaBench },
+        { "scaling", bench::runScalingBench },
+        { "dates", bench::runDateBench },
+        { "preview", bench::runPreviewBench },
+    };
+
+    void printUsage() {
+        std::printf("usage: steamfeed_bench [--items N] [--iterations N] [--only SCENARIO]... [--font file.fnt]... [payload.json]...\n");
+        std::printf("scenarios:");
+        for (const auto& scenario : s_scenarios) {
+            std::printf(" %s", scenario.name);
+        }
+        std::printf("\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    bench::Options options;
+    std::vector<std::string> only;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--items") == 0 && hasValue) {
+            options.itemCount = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--iterations") == 0 && hasValue) {
+            options.iterations = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--font") == 0 && hasValue) {
+            options.fontFiles.push_back(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--only") == 0 && hasValue) {
+            only.push_back(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--help") == 0) {
+            printUsage();
+            return EXIT_SUCCESS;
+        }
+        else if (argv[i][0] == '-') {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+        else {
+            options.payloadFiles.push_back(argv[i]);
+        }
+    }
+
+    auto payloads = bench::loadPayloads(options);
+    if (payloads.empty()) {
+        return EXIT_FAILURE;
+    }
+
+    for (const auto& scenario : s_scenarios) {
+        bool selected = only.empty();
+        for (const auto& name : only) {
+            selected |= name == scenario.name;
+        }
+        if (selected) {
+            scenario.run(options, payloads);
+        }
+    }
+    if (bench::s_failed) {
+        std::printf("\nFAILED: a check above failed\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,152 @@
+#include "NewsCell.hpp"
+#include "core/FontMetrics.hpp"
+#include <unordered_map>
+#include <Geode/binding/CCMenuItemSpriteExtra.hpp>
+#include <Geode/loader/Log.hpp>
+
+using namespace cocos2d;
+
+namespace {
+    constexpr float Padding = 40;
+    constexpr float ShadowOffset = 2;
+    constexpr GLubyte ShadowOpacity = 100;
+    constexpr float TitleScale = 0.8f;
+    constexpr float DateScale = 0.4f;
+    constexpr float ContentScale = 0.8f;
+    constexpr float ReadMoreScale = 0.5f;
+    // content lines of an article shown until it's expanded, patch notes run to hundreds
+    constexpr std::uint32_t PreviewLines = 8;
+
+    // Glyph metrics of the fonts the feed is laid out in, read once from the .fnt of the
+    // texture quality in use. Null when it can't be read.
+    const steamfeed::FontMetrics* fontMetrics(const char* fontFile) {
+        static std::unordered_map<std::string, steamfeed::FontMetrics> fonts;
+        auto [font, inserted] = fonts.try_emplace(fontFile);
+        if (inserted) {
+            std::string path = CCFileUtils::sharedFileUtils()->fullPathForFilename(fontFile, false);
+            if (!font->second.loadFile(path)) {
+                geode::log::warn("Couldn't read the metrics of {}, measuring with labels instead", fontFile);
+            }
+        }
+        return font->second.empty() ? nullptr : &font->second;
+    }
+
+    // one per thread, layouts run on the layer's worker as well as the main thread
+    steamfeed::WordWidthCache& wordWidths() {
+        thread_local steamfeed::WordWidthCache cache;
+        return cache;
+    }
+
+    steamfeed::LayoutFont layoutFont(const char* fontFile, float scale) {
+        steamfeed::LayoutFont font;
+        font.scale = scale;
+        if (auto metrics = fontMetrics(fontFile)) {
+            // the .fnt advances are in texture pixels, the labels are laid out in points
+            float pixels = 1.0f / CC_CONTENT_SCALE_FACTOR();
+            font.lineHeight = static_cast<float>(metrics->lineHeight()) * pixels;
+            font.measure = [metrics, pixels](std::string_view word) {
+                return wordWidths().measure(*metrics, word) * pixels;
+            };
+            return font;
+        }
+
+        // the labels are autoreleased, releasing them here as well would free them twice
+        font.lineHeight = CCLabelBMFont::create("A", fontFile)->getContentSize().height;
+        font.measure = [fontFile](std::string_view word) {
+            return CCLabelBMFont::create(std::string(word).c_str(), fontFile)->getContentSize().width;
+        };
+        return font;
+    }
+}
+
+NewsCell* NewsCell::create(float width, ExpandCallback onExpand) {
+    auto cell = new NewsCell();
+    if (cell->init(width, std::move(onExpand))) {
+        cell->autorelease();
+        return cell;
+    }
+    delete cell;
+    return nullptr;
+}
+
+float NewsCell::feedWidth() {
+    return CCDirector::sharedDirector()->getWinSize().width - 150; // For avoiding arrow overlap
+}
+
+steamfeed::NewsLayoutStyle NewsCell::layoutStyle(float width) {
+    steamfeed::NewsLayoutStyle style;
+    style.width = width;
+    style.padding = Padding;
+    style.title = layoutFont("goldFont.fnt", TitleScale);
+    style.date = layoutFont("bigFont.fnt", DateScale);
+    style.content = layoutFont("chatFont.fnt", ContentScale);
+    style.previewLines = PreviewLines;
+    return style;
+}
+
+bool NewsCell::canLayoutOffThread() {
+    return fontMetrics("goldFont.fnt") && fontMetrics("bigFont.fnt") && fontMetrics("chatFont.fnt");
+}
+
+bool NewsCell::init(float width, ExpandCallback onExpand) {
+    if (!CCNode::init()) {
+        return false;
+    }
+    m_width = width;
+    m_onExpand = std::move(onExpand);
+
+    m_title = addLabel("goldFont.fnt", TitleScale);
+    m_date = addLabel("bigFont.fnt", DateScale);
+    m_date->setOpacity(128);
+    // the layout breaks the lines, the label doesn't wrap on its own
+    m_content = addLabel("chatFont.fnt", ContentScale);
+
+    // across from the date, only there while the article is cut short
+    auto readMoreLabel = CCLabelBMFont::create("Read more", "goldFont.fnt");
+    readMoreLabel->setScale(ReadMoreScale);
+    m_readMoreBtn = CCMenuItemSpriteExtra::create(readMoreLabel, readMoreLabel, this, menu_selector(NewsCell::onReadMore));
+    m_readMore = CCMenu::create(m_readMoreBtn, nullptr);
+    m_readMore->setPosition(CCPointZero);
+    m_readMore->setVisible(false);
+    this->addChild(m_readMore);
+    return true;
+}
+
+void NewsCell::onReadMore(CCObject* sender) {
+    if (m_onExpand) {
+        m_onExpand(this);
+    }
+}
+
+ShadowLabel* NewsCell::addLabel(const char* fontFile, float scale) {
+    auto label = ShadowLabel::create("", fontFile);
+    label->setAnchorPoint(ccp(0, 1));
+    label->setScale(scale);
+    label->setShadow(ccp(ShadowOffset, -ShadowOffset), ShadowOpacity);
+    this->addChild(label);
+    return label;
+}
+
+void NewsCell::setArticle(const steamfeed::NewsLayout& layout, std::size_t index,
+    std::string_view title, std::string_view content, std::string_view date) {
+    const auto& article = layout[index];
+    this->setContentSize(CCSizeMake(m_width, article.height));
+
+    steamfeed::NewsLayout::joinLines(title, layout.titleLines(index), m_lineBuffer);
+    m_title->setString(m_lineBuffer.c_str());
+    m_title->setPosition(ccp(Padding, article.titleTop));
+
+    m_date->setString(date.data());
+    m_date->setPosition(ccp(Padding, article.dateTop));
+
+    steamfeed::NewsLayout::joinLines(content, layout.contentLines(index), m_lineBuffer);
+    m_content->setString(m_lineBuffer.c_str());
+    m_content->setPosition(ccp(Padding, article.contentTop));
+
+    m_readMore->setVisible(article.truncated);
+    if (article.truncated) {
+        // the button is placed by its centre, which lines up with the date's
+        auto size = m_readMoreBtn->getContentSize();
+        m_readMoreBtn->setPosition(ccp(m_width - 2 * Padding - size.width / 2, article.dateTop - size.height / 2));
+    }
+}
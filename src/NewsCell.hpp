@@ -0,0 +1,47 @@
+#pragma once
+
+#include "ShadowLabel.hpp"
+#include "core/NewsLayout.hpp"
+#include <cocos2d.h>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// One article in the feed. The scroll view hands cells from article to article as it scrolls,
+// so the labels are created once and after that only get their strings swapped. Long articles
+// show a preview with a "Read more" button until they're expanded.
+class NewsCell : public cocos2d::CCNode {
+public:
+    // Called when the cell's "Read more" is pressed, cells don't know where their article is in the feed
+    using ExpandCallback = std::function<void(NewsCell* cell)>;
+
+    static NewsCell* create(float width, ExpandCallback onExpand);
+
+    // How wide the cells of the feed are in this window, leaving room for the layer's arrows
+    static float feedWidth();
+
+    // The fonts and scales the cells draw with, for laying out a feed of cells this wide.
+    // Has to be called on the main thread, the style it returns can go anywhere.
+    static steamfeed::NewsLayoutStyle layoutStyle(float width);
+    // Whether the fonts could be read, without them layouts measure with labels and have to
+    // stay on the main thread
+    static bool canLayoutOffThread();
+
+    // Fills the cell with an article the way the layout placed it. The date has to be '\0' terminated.
+    void setArticle(const steamfeed::NewsLayout& layout, std::size_t index,
+        std::string_view title, std::string_view content, std::string_view date);
+
+private:
+    bool init(float width, ExpandCallback onExpand);
+    ShadowLabel* addLabel(const char* fontFile, float scale);
+    void onReadMore(cocos2d::CCObject* sender);
+
+    float m_width = 0;
+    ExpandCallback m_onExpand;
+    cocos2d::CCMenu* m_readMore = nullptr;
+    cocos2d::CCNode* m_readMoreBtn = nullptr;
+    ShadowLabel* m_title = nullptr;
+    ShadowLabel* m_date = nullptr;
+    ShadowLabel* m_content = nullptr;
+    std::string m_lineBuffer; // joined lines for the labels, kept for its capacity
+};
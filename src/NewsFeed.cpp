@@ -0,0 +1,491 @@
+#include "NewsFeed.hpp"
+#include "NewsCell.hpp"
+#include "core/GidRules.hpp"
+#include "core/NewsDedup.hpp"
+#include "core/NewsItemView.hpp"
+#include "core/NewsParser.hpp"
+#include "core/TaskPool.hpp"
+#include <memory>
+#include <unordered_set>
+#include <Geode/binding/LevelEditorLayer.hpp>
+#include <Geode/binding/PlayLayer.hpp>
+#include <Geode/loader/Loader.hpp>
+#include <Geode/loader/Log.hpp>
+#include <Geode/loader/Mod.hpp>
+
+using namespace cocos2d;
+using namespace geode::prelude;
+
+namespace {
+    std::filesystem::path cachePath() {
+        return Mod::get()->getSaveDir() / "news_cache.bin";
+    }
+
+    // loaded from the bundled resource the first time a response comes in
+    const steamfeed::GidRuleTable& gidRules() {
+        static const steamfeed::GidRuleTable rules = [] {
+            steamfeed::GidRuleTable table;
+            if (!table.loadFile(Mod::get()->getResourcesDir() / "gid_rules.json")) {
+                geode::log::error("Couldn't load gid_rules.json, no articles will be filtered");
+            }
+            return table;
+        }();
+        return rules;
+    }
+
+    steamfeed::NewsLayoutStyle layoutStyle() {
+        return NewsCell::layoutStyle(NewsCell::feedWidth());
+    }
+
+    // A level is loading, being played or edited, which gets the CPU to itself
+    bool levelBusy() {
+        return PlayLayer::get() || LevelEditorLayer::get();
+    }
+
+    // saved values the validators of the newest page are kept under
+    constexpr auto ValidatedUrlKey = "news-validated-url";
+    constexpr auto ETagKey = "news-etag";
+    constexpr auto LastModifiedKey = "news-last-modified";
+
+    // articles per batch once the first screenful is out
+    constexpr size_t OlderBatchSize = 32;
+    // the layer builds cells this far below the view as well, they're part of the first screenful
+    constexpr float FirstScreenMargin = 200;
+}
+
+// Sanitized articles, what they point into and their layout
+struct NewsFeed::PreparedFeed {
+    std::vector<steamfeed::NewsItemView> items;
+    std::vector<steamfeed::NewsFingerprint> fingerprints; // of the sanitized text, one per article
+    std::shared_ptr<const void> owner;
+    steamfeed::NewsLayout layout;
+    bool parsed = true;
+    // articles in the response before anything was dropped and the oldest of their dates, for the pager
+    size_t received = 0;
+    int64_t oldestReceived = 0;
+};
+
+NewsFeed& NewsFeed::get() {
+    // never released, the scheduler and the web tasks may still point at it while the game shuts down
+    static NewsFeed* feed = new NewsFeed();
+    return *feed;
+}
+
+NewsFeed::NewsFeed() {
+    // the cached feed goes out as soon as it's laid out, the first refresh then only brings in newer articles
+    m_cache.open(cachePath());
+    auto cachedItems = m_cache.items();
+    if (cachedItems.empty()) {
+        return;
+    }
+
+    // only of use along with the articles they were sent with
+    auto mod = Mod::get();
+    m_validatedUrl = mod->getSavedValue<std::string>(ValidatedUrlKey);
+    m_validators.etag = mod->getSavedValue<std::string>(ETagKey);
+    m_validators.lastModified = mod->getSavedValue<std::string>(LastModifiedKey);
+
+    // the feed shows the articles straight out of the mapping, which it holds on to until a
+    // store replaces the file
+    m_loadingCache = true;
+    auto prepared = std::make_shared<PreparedFeed>();
+    prepared->items = std::move(cachedItems);
+    prepared->owner = m_cache.owner();
+    runJob([prepared, offThread = NewsCell::canLayoutOffThread(), style = layoutStyle()] {
+        for (const auto& item : prepared->items) {
+            prepared->fingerprints.push_back(steamfeed::fingerprintNews(item.title, item.content));
+        }
+
+        // a whole feed is worth a few threads for the one load, pages are too short for them.
+        // Measuring with labels has to stay on the main thread.
+        steamfeed::TaskPool pool(offThread ? steamfeed::TaskPool::defaultThreads() : 1);
+        prepared->layout = steamfeed::NewsLayout(style);
+        prepared->layout.append(prepared->items, pool);
+    }, [this, prepared] {
+        m_loadingCache = false;
+        if (m_store.empty()) {
+            m_seen.clear();
+            dropReposts(*prepared);
+            m_store.replace(std::move(prepared->items), std::move(prepared->owner), std::move(prepared->layout));
+        }
+    });
+}
+
+NewsFeed::Subscription NewsFeed::subscribe(Listener listener) {
+    keepPolling();
+    return Subscription(m_store, std::move(listener));
+}
+
+std::chrono::minutes NewsFeed::refreshInterval() {
+    return std::chrono::minutes(Mod::get()->getSettingValue<int64_t>("refresh-interval"));
+}
+
+void NewsFeed::refresh() {
+    if (m_fetching) {
+        return;
+    }
+    bool haveFeed = !m_store.empty() || m_loadingCache;
+    if (haveFeed && m_fetched && std::chrono::steady_clock::now() - m_lastFetch < refreshInterval()) {
+        return;
+    }
+    fetchNewsItems(haveFeed);
+}
+
+void NewsFeed::loadOlder(bool retry) {
+    const auto& items = m_store.snapshot()->items;
+    if (items.empty() || items.size() >= static_cast<size_t>(steamfeed::FullFeedCount)) {
+        return;
+    }
+    // anything still on the worker lands at the bottom first
+    if (!m_worker.idle()) {
+        return;
+    }
+    if (retry) {
+        m_pager.retry();
+    }
+    m_pager.requestOlder(items.back().timestamp);
+}
+
+void NewsFeed::prefetch() {
+    // the next visit to the menu tries again
+    if (levelBusy()) {
+        return;
+    }
+    refresh();
+}
+
+void NewsFeed::expand(size_t index) {
+    const auto& snapshot = *m_store.snapshot();
+    if (index >= snapshot.items.size() || !snapshot.layout[index].truncated) {
+        return;
+    }
+    // one article, quick enough for the main thread even for long patch notes
+    auto layout = snapshot.layout;
+    const auto& item = snapshot.items[index];
+    layout.expand(index, item.title, item.content);
+    m_store.relayout(index, std::move(layout));
+}
+
+void NewsFeed::runJob(steamfeed::FeedWorker::Job job, steamfeed::FeedWorker::Done done) {
+    keepPolling();
+    if (NewsCell::canLayoutOffThread()) {
+        m_worker.post(std::move(job), std::move(done));
+        return;
+    }
+    // measuring with labels, which only works on the main thread. It waits for a frame's
+    // poll, which doesn't happen while a level loads or plays, and its completion for the next.
+    m_worker.postOnPoll(std::move(job), std::move(done));
+}
+
+void NewsFeed::keepPolling() {
+    if (!m_polling) {
+        CCDirector::sharedDirector()->getScheduler()->scheduleSelector(schedule_selector(NewsFeed::onFrame), this, 0, false);
+        m_polling = true;
+    }
+}
+
+void NewsFeed::onFrame(float dt) {
+    // a job that is running already finishes, nothing after it starts until the level is over
+    bool throttled = levelBusy();
+    if (throttled != m_throttled) {
+        m_worker.setPaused(throttled);
+        m_throttled = throttled;
+    }
+    if (throttled) {
+        return;
+    }
+
+    m_worker.poll();
+    if (m_store.subscribers() > 0) {
+        // a failed fetch waits for the timer as well, rather than going again every frame
+        if (m_fetched && std::chrono::steady_clock::now() - m_lastFetch >= refreshInterval()) {
+            refresh();
+        }
+        return;
+    }
+    // nobody is looking and nothing is left to complete, the next subscriber or job starts it again
+    if (m_worker.idle()) {
+        CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(schedule_selector(NewsFeed::onFrame), this);
+        m_polling = false;
+    }
+}
+
+void NewsFeed::fetchNewsItems(bool refresh) {
+    geode::log::info("Fetching the SteamNews items...");
+    m_fetching = true;
+    m_fetched = true;
+    m_lastFetch = std::chrono::steady_clock::now();
+
+    // only the newest page either way, older ones load as readers scroll down
+    std::string url = steamfeed::newsUrl(refresh ? steamfeed::RefreshPageCount : steamfeed::FirstPageCount);
+    bool replaceFeed = !refresh;
+
+    auto req = geode::utils::web::WebRequest();
+    // an unchanged page comes back without a body, the feed already has it
+    bool conditional = (!m_store.empty() || m_loadingCache) && url == m_validatedUrl;
+    if (conditional) {
+        for (const auto& [name, value] : steamfeed::conditionalHeaders(m_validators)) {
+            req.header(name, value);
+        }
+    }
+    m_listener.bind([this, replaceFeed, url](web::WebTask::Event* e) {
+        if (auto res = e->getValue()) {
+            if (res->code() == 304) {
+                geode::log::info("The SteamNews haven't changed since the last fetch");
+                m_fetching = false;
+                return;
+            }
+            auto response = res->string().unwrapOr("");
+            if (!res->ok() || response.empty()) {
+                m_fetching = false;
+                return;
+            }
+            steamfeed::HttpValidators validators{ res->header("ETag").value_or(""), res->header("Last-Modified").value_or("") };
+
+            if (replaceFeed) {
+                m_pager.reset(); // older pages of the feed being replaced are of no use
+            }
+            // nothing to merge with, so the articles can go out while the rest is parsed
+            if (replaceFeed && m_store.empty() && !m_loadingCache) {
+                streamNewsItems(std::move(response), url, std::move(validators));
+                return;
+            }
+
+            // parsing, sanitizing and layout on the worker, the main thread only merges
+            auto prepared = std::make_shared<PreparedFeed>();
+            const auto* rules = &gidRules();
+            runJob([prepared, rules, scratch = &m_scratch, style = layoutStyle(), response = std::move(response)]() mutable {
+                auto feed = std::make_shared<steamfeed::ParsedFeed>();
+                prepared->layout = steamfeed::NewsLayout(style);
+                prepared->parsed = feed->parse(std::move(response), *rules, [&](const steamfeed::NewsItemView& item) {
+                    prepared->layout.append(item.title, item.content);
+                    prepared->fingerprints.push_back(steamfeed::fingerprintNews(item.title, item.content));
+                    return true;
+                }, scratch);
+                // a truncated or malformed response shows nothing rather than half a feed
+                if (prepared->parsed) {
+                    prepared->items = feed->items();
+                    prepared->owner = std::move(feed);
+                }
+            }, [this, prepared, replaceFeed, url, validators = std::move(validators)] {
+                m_fetching = false;
+                if (applyNewsItems(*prepared, replaceFeed)) {
+                    saveValidators(url, validators);
+                }
+            });
+        }
+        else if (e->isCancelled()) {
+            m_fetching = false;
+        }
+        });
+
+    m_listener.setFilter(req.get(url));
+}
+
+void NewsFeed::streamNewsItems(std::string response, const std::string& url, steamfeed::HttpValidators validators) {
+    auto prepared = std::make_shared<PreparedFeed>();
+    auto worker = &m_worker;
+    const auto* rules = &gidRules();
+    float firstScreen = CCDirector::sharedDirector()->getWinSize().height + FirstScreenMargin;
+    // the feed is empty, the batches fill it from scratch
+    m_seen.clear();
+    runJob([this, prepared, worker, rules, firstScreen, style = layoutStyle(), response = std::move(response)]() mutable {
+        // every batch points into the one feed, the articles it handed out stay put while it parses on
+        auto feed = std::make_shared<steamfeed::ParsedFeed>();
+        auto batch = std::make_shared<PreparedFeed>();
+        batch->owner = feed;
+        batch->layout = steamfeed::NewsLayout(style);
+        bool shown = false;
+        prepared->parsed = feed->parse(std::move(response), *rules, [&](const steamfeed::NewsItemView& item) {
+            batch->layout.append(item.title, item.content);
+            batch->items.push_back(item);
+            batch->fingerprints.push_back(steamfeed::fingerprintNews(item.title, item.content));
+
+            // the first screenful goes out the moment it's laid out, older articles follow in batches
+            bool full = shown ? batch->items.size() >= OlderBatchSize : batch->layout.totalHeight() >= firstScreen;
+            if (full) {
+                worker->publish([this, batch] {
+                    dropReposts(*batch);
+                    m_store.append(std::move(batch->items), batch->owner, batch->layout);
+                });
+                batch = std::make_shared<PreparedFeed>();
+                batch->owner = feed;
+                batch->layout = steamfeed::NewsLayout(style);
+                shown = true;
+            }
+            return true;
+        }, &m_scratch);
+        prepared->items = std::move(batch->items);
+        prepared->fingerprints = std::move(batch->fingerprints);
+        prepared->owner = std::move(batch->owner);
+        prepared->layout = std::move(batch->layout);
+    }, [this, prepared, url, validators = std::move(validators)] {
+        m_fetching = false;
+        dropReposts(*prepared);
+        m_store.append(std::move(prepared->items), prepared->owner, prepared->layout);
+        if (!prepared->parsed) {
+            // keeping what already went out, but not letting half a feed into the cache
+            geode::log::warn("Steam Feed: The news response was cut off, not caching it");
+            return;
+        }
+        storeNewsItems();
+        saveValidators(url, validators);
+    });
+}
+
+void NewsFeed::fetchOlderNewsItems(const std::string& url) {
+    geode::log::info("Fetching older SteamNews items...");
+
+    // the page starts at the oldest article in the feed, which comes back with it
+    std::unordered_set<std::string> boundary;
+    const auto& items = m_store.snapshot()->items;
+    auto oldest = items.back().timestamp;
+    for (auto it = items.rbegin(); it != items.rend() && it->timestamp == oldest; ++it) {
+        boundary.emplace(it->gid);
+    }
+
+    m_olderListener.bind([this, url, boundary = std::move(boundary)](web::WebTask::Event* e) {
+        if (auto res = e->getValue()) {
+            auto response = res->string().unwrapOr("");
+            if (!res->ok() || response.empty()) {
+                m_pager.pageFailed(url);
+                return;
+            }
+
+            auto prepared = std::make_shared<PreparedFeed>();
+            const auto* rules = &gidRules();
+            runJob([prepared, rules, boundary, scratch = &m_scratch, style = layoutStyle(), response = std::move(response)]() mutable {
+                auto feed = std::make_shared<steamfeed::ParsedFeed>();
+                prepared->layout = steamfeed::NewsLayout(style);
+                prepared->parsed = feed->parse(std::move(response), *rules, [&](const steamfeed::NewsItemView& item) {
+                    if (!boundary.contains(std::string(item.gid))) {
+                        prepared->layout.append(item.title, item.content);
+                        prepared->items.push_back(item);
+                        prepared->fingerprints.push_back(steamfeed::fingerprintNews(item.title, item.content));
+                    }
+                    return true;
+                }, scratch);
+                prepared->received = feed->received();
+                prepared->oldestReceived = feed->oldestReceived();
+                prepared->owner = std::move(feed);
+            }, [this, prepared, url] {
+                if (!m_pager.pending(url)) {
+                    return; // the feed was replaced while the page loaded
+                }
+                if (!prepared->parsed) {
+                    m_pager.pageFailed(url);
+                    return;
+                }
+                // whether the feed ends goes by the page as it came, not by what's left of it
+                dropReposts(*prepared);
+                m_pager.pageLoaded(url, prepared->received, prepared->oldestReceived);
+                if (!prepared->items.empty()) {
+                    m_store.append(std::move(prepared->items), std::move(prepared->owner), prepared->layout);
+                    storeNewsItems();
+                }
+            });
+        }
+        else if (e->isCancelled()) {
+            m_pager.pageFailed(url);
+        }
+        });
+
+    auto req = geode::utils::web::WebRequest();
+    m_olderListener.setFilter(req.get(url));
+}
+
+bool NewsFeed::applyNewsItems(PreparedFeed& prepared, bool replaceFeed) {
+    if (prepared.items.empty()) {
+        return false; // nothing usable came back, keep the feed as it is
+    }
+    if (replaceFeed || m_store.empty()) {
+        m_seen.clear();
+        dropReposts(prepared);
+        m_store.replace(std::move(prepared.items), std::move(prepared.owner), std::move(prepared.layout));
+        storeNewsItems();
+        return true;
+    }
+
+    // the merge hands back where in the page the newer articles are, their layouts and
+    // fingerprints are found by the same index
+    auto merged = m_store.snapshot()->items;
+    const auto& fresh = prepared.items;
+    std::vector<size_t> newer;
+    if (!steamfeed::mergeNewerItems(merged, fresh, &newer)) {
+        // the refresh page didn't reach back to the articles we have
+        fetchNewsItems(false);
+        return false;
+    }
+    if (newer.empty()) {
+        return true; // already up to date
+    }
+
+    // the merge only knows gids, a repost under a new one is caught here
+    std::vector<steamfeed::NewsItemView> newerItems;
+    steamfeed::NewsLayout newerLayout(layoutStyle());
+    for (auto index : newer) {
+        if (m_seen.isDuplicate(prepared.fingerprints[index])) {
+            continue;
+        }
+        newerLayout.append(prepared.layout, index);
+        newerItems.push_back(fresh[index]);
+    }
+    if (newerItems.empty()) {
+        return true;
+    }
+    // keeping the feed at the size of a full one, dropping the oldest. The rest of the page is
+    // kept alive with them, it's part of the same buffer.
+    m_store.prepend(std::move(newerItems), std::move(prepared.owner), newerLayout, steamfeed::FullFeedCount);
+    storeNewsItems();
+    return true;
+}
+
+void NewsFeed::dropReposts(PreparedFeed& prepared) {
+    std::vector<size_t> kept;
+    for (size_t i = 0; i < prepared.items.size(); i++) {
+        if (!m_seen.isDuplicate(prepared.fingerprints[i])) {
+            kept.push_back(i);
+        }
+    }
+    if (kept.size() == prepared.items.size()) {
+        return;
+    }
+
+    // the layouts of the articles kept carry over, nothing gets measured again
+    PreparedFeed filtered;
+    filtered.layout = steamfeed::NewsLayout(layoutStyle());
+    for (auto index : kept) {
+        filtered.items.push_back(prepared.items[index]);
+        filtered.fingerprints.push_back(prepared.fingerprints[index]);
+        filtered.layout.append(prepared.layout, index);
+    }
+    prepared.items = std::move(filtered.items);
+    prepared.fingerprints = std::move(filtered.fingerprints);
+    prepared.layout = std::move(filtered.layout);
+}
+
+void NewsFeed::storeNewsItems() {
+    if (m_store.empty()) {
+        return;
+    }
+    // articles still shown out of the cache's mapping are copied off it first, Windows won't
+    // replace a mapped file. That's only ever the articles the feed started with.
+    m_store.detach(m_cache.owner());
+    m_cacheStale = !m_cache.store(m_store.snapshot()->items);
+    if (m_cacheStale) {
+        geode::log::warn("Steam Feed: Failed to write the news cache");
+    }
+}
+
+void NewsFeed::saveValidators(const std::string& url, steamfeed::HttpValidators validators) {
+    // a cache that's behind would get a 304 for articles it doesn't have on the next start
+    if (m_cacheStale) {
+        validators = {};
+    }
+    m_validatedUrl = url;
+    m_validators = std::move(validators);
+    auto mod = Mod::get();
+    mod->setSavedValue<std::string>(ValidatedUrlKey, m_validatedUrl);
+    mod->setSavedValue<std::string>(ETagKey, m_validators.etag);
+    mod->setSavedValue<std::string>(LastModifiedKey, m_validators.lastModified);
+}
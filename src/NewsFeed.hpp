@@ -0,0 +1,103 @@
+#pragma once
+
+#include <Geode/loader/Event.hpp>
+#include <Geode/utils/web.hpp>
+#include <chrono>
+#include <cocos2d.h>
+#include <string>
+#include <vector>
+#include "core/FeedPager.hpp"
+#include "core/FeedStore.hpp"
+#include "core/FeedWorker.hpp"
+#include "core/HttpValidators.hpp"
+#include "core/NewsApi.hpp"
+#include "core/NewsCache.hpp"
+#include "core/NewsDedup.hpp"
+#include "core/NewsItem.hpp"
+#include "core/NewsLayout.hpp"
+#include "core/ScratchArena.hpp"
+
+// The feed behind every SteamNewsLayer. It owns the downloads, the worker, the cache and the
+// parsed articles, and hands the layers immutable snapshots, so opening the layer again costs
+// no network or parsing while the feed is fresh and any number of layers share one copy of it.
+// Main thread only.
+class NewsFeed : public cocos2d::CCObject {
+public:
+    using Snapshot = steamfeed::FeedStore::Snapshot;
+    using Listener = steamfeed::FeedStore::Listener;
+    using Subscription = steamfeed::FeedSubscription;
+
+    // Created on first use with whatever the cache holds, and kept until the game exits
+    static NewsFeed& get();
+
+    const Snapshot& snapshot() const { return m_store.snapshot(); }
+    // Listens until the subscription is reset or destroyed
+    Subscription subscribe(Listener listener);
+
+    // Fetches the newest page, unless it was fetched less than refreshInterval() ago or is on its
+    // way already. An empty feed is fetched again whenever this is called, the timer only
+    // retries it once the interval is up.
+    void refresh();
+    // The next older page, for when a reader nears the bottom. After a failed page it waits a
+    // while before asking again, unless retry says the reader asked for it.
+    void loadOlder(bool retry = false);
+    // A refresh nobody is waiting for yet, skipped while a level is loading or being played
+    void prefetch();
+    // Lays out the rest of an article the feed only shows a preview of
+    void expand(size_t index);
+
+    // How long a fetched feed is good for, from the mod's settings. The timer refreshes it
+    // while anyone is subscribed.
+    static std::chrono::minutes refreshInterval();
+
+private:
+    // What the worker hands back for the main thread to publish
+    struct PreparedFeed;
+
+    NewsFeed();
+
+    // The newest page of the feed, merged into the snapshot on a refresh and replacing it otherwise
+    void fetchNewsItems(bool refresh);
+    // Parses a full feed on the worker and publishes it in batches as it comes, newest first
+    void streamNewsItems(std::string response, const std::string& url, steamfeed::HttpValidators validators);
+    void fetchOlderNewsItems(const std::string& url);
+    // Merges or swaps in a page the worker parsed and laid out, taking its articles. False when
+    // the page didn't make it into the feed.
+    bool applyNewsItems(PreparedFeed& prepared, bool replaceFeed);
+    // Drops the articles of a page the feed already shows under another gid and remembers the
+    // rest, which have to be on their way into the feed
+    void dropReposts(PreparedFeed& prepared);
+    // Writes the current snapshot to the cache
+    void storeNewsItems();
+    // Keeps the validators of the newest page once both it and the cache hold what they describe
+    void saveValidators(const std::string& url, steamfeed::HttpValidators validators);
+    // Runs job on the worker and done on the main thread once it's through. Without off-thread
+    // layout the job runs on the main thread too, in a later frame with no level going on.
+    void runJob(steamfeed::FeedWorker::Job job, steamfeed::FeedWorker::Done done);
+    // Polls the worker every frame until there are neither subscribers nor jobs left. While a
+    // level loads or plays it leaves the completions waiting and the worker paused instead.
+    void keepPolling();
+    void onFrame(float dt);
+
+    steamfeed::FeedStore m_store;
+    // fingerprints of every article that went into the feed since it was last replaced, pages
+    // only dedup against themselves. Ones that fell off the bottom of a full feed stay in it.
+    steamfeed::NewsDedup m_seen;
+    steamfeed::NewsCache m_cache;
+    geode::EventListener<geode::utils::web::WebTask> m_listener;
+    geode::EventListener<geode::utils::web::WebTask> m_olderListener;
+    steamfeed::FeedPager m_pager{ [this](const std::string& url) { fetchOlderNewsItems(url); }, steamfeed::OlderPageCount };
+    std::chrono::steady_clock::time_point m_lastFetch;
+    bool m_fetched = false;      // m_lastFetch is set
+    bool m_fetching = false;     // the newest page is on its way or on the worker
+    bool m_loadingCache = false; // the cached feed is being laid out, a fetch merges into it
+    bool m_polling = false;
+    bool m_cacheStale = false;   // the last store failed, the cache is behind the snapshot
+    // of the newest page as the feed and cache have it, sent along so an unchanged feed comes back as a bare 304
+    steamfeed::HttpValidators m_validators;
+    std::string m_validatedUrl;
+    bool m_throttled = false;    // the worker is paused for a level
+    // the parses' working tables, only touched by jobs, which never run two at a time
+    steamfeed::ScratchArena m_scratch;
+    steamfeed::FeedWorker m_worker; // last, so it stops before anything its jobs complete into goes away
+};
@@ -0,0 +1,86 @@
+#include "ShadowLabel.hpp"
+
+using namespace cocos2d;
+
+ShadowLabel* ShadowLabel::create(const char* text, const char* fontFile) {
+    auto label = new ShadowLabel();
+    if (label->initWithString(text, fontFile)) {
+        label->autorelease();
+        return label;
+    }
+    delete label;
+    return nullptr;
+}
+
+ShadowLabel::~ShadowLabel() {
+    CC_SAFE_RELEASE(m_shadowAtlas);
+}
+
+void ShadowLabel::setShadow(CCPoint offset, GLubyte opacity) {
+    m_shadowOffset = offset;
+    m_shadowOpacity = opacity;
+    m_shadowChanged = true;
+}
+
+void ShadowLabel::draw() {
+    auto atlas = this->getTextureAtlas();
+    if (m_shadowOpacity == 0 || atlas->getTotalQuads() == 0) {
+        if (m_glyphsUndrawn) {
+            atlas->setDirty(true);
+            m_glyphsUndrawn = false;
+        }
+        CCLabelBMFont::draw();
+        return;
+    }
+
+    // what CCSpriteBatchNode::draw does, with the combined buffer in place of the glyphs' own
+    CC_NODE_DRAW_SETUP();
+    arrayMakeObjectsPerformSelector(m_pChildren, updateTransform, CCSprite*);
+    updateShadowAtlas(atlas);
+    ccGLBlendFunc(m_blendFunc.src, m_blendFunc.dst);
+    m_shadowAtlas->drawQuads();
+}
+
+void ShadowLabel::updateShadowAtlas(CCTextureAtlas* glyphs) {
+    // the quads are in the label's space, which the node's scale still applies to
+    auto shift = ccp(m_shadowOffset.x / this->getScaleX(), m_shadowOffset.y / this->getScaleY());
+    // the glyph sprites mark their buffer dirty whenever they write a quad
+    if (m_shadowAtlas && !glyphs->isDirty() && !m_shadowChanged && shift.equals(m_shadowShift)
+        && m_shadowAtlas->getTexture() == glyphs->getTexture()) {
+        return;
+    }
+
+    auto count = glyphs->getTotalQuads();
+    if (!m_shadowAtlas) {
+        m_shadowAtlas = CCTextureAtlas::createWithTexture(glyphs->getTexture(), 2 * count);
+        m_shadowAtlas->retain();
+    }
+    else {
+        m_shadowAtlas->setTexture(glyphs->getTexture());
+        m_shadowAtlas->removeAllQuads();
+        if (m_shadowAtlas->getCapacity() < 2 * count) {
+            m_shadowAtlas->resizeCapacity(2 * count);
+        }
+    }
+
+    // black with the glyphs' alpha, the textures are premultiplied so the label's blend func still fits
+    auto quads = glyphs->getQuads();
+    ccColor4B shadow = { 0, 0, 0, m_shadowOpacity };
+    m_quads.assign(quads, quads + count);
+    for (auto& quad : m_quads) {
+        for (auto corner : { &quad.bl, &quad.br, &quad.tl, &quad.tr }) {
+            corner->vertices.x += shift.x;
+            corner->vertices.y += shift.y;
+            corner->colors = shadow;
+        }
+    }
+    // drawn in order, so the shadows go first
+    m_quads.insert(m_quads.end(), quads, quads + count);
+    m_shadowAtlas->insertQuads(m_quads.data(), 0, 2 * count);
+
+    // the label's own buffer isn't drawn while the shadow is on, only the combined one gets uploaded
+    glyphs->setDirty(false);
+    m_glyphsUndrawn = true;
+    m_shadowShift = shift;
+    m_shadowChanged = false;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cocos2d.h>
+#include <vector>
+
+// A bitmap font label that draws its own drop shadow. The glyph quads go into a second buffer
+// of the label's, each one after an offset black copy of itself, and the whole buffer is drawn
+// in one call with the label's own shader. There is no second label keeping its own glyph
+// sprites in sync with the first, and no second draw call for the shadow.
+class ShadowLabel : public cocos2d::CCLabelBMFont {
+public:
+    static ShadowLabel* create(const char* text, const char* fontFile);
+    ~ShadowLabel();
+
+    // Offset in the parent's space, opacity 0 turns the shadow off. The shadow doesn't
+    // follow the label's own opacity, same as the separate shadow labels never did.
+    void setShadow(cocos2d::CCPoint offset, GLubyte opacity);
+
+    virtual void draw() override;
+
+private:
+    // Copies the glyph quads and their shadows into m_shadowAtlas, only when the glyphs or
+    // the shadow changed since the last copy
+    void updateShadowAtlas(cocos2d::CCTextureAtlas* glyphs);
+
+    cocos2d::CCPoint m_shadowOffset = ccp(2, -2);
+    GLubyte m_shadowOpacity = 100;
+    cocos2d::CCTextureAtlas* m_shadowAtlas = nullptr; // the shadows, then the glyphs
+    cocos2d::CCPoint m_shadowShift;  // the offset the atlas was built with, in the label's space
+    bool m_shadowChanged = true;
+    bool m_glyphsUndrawn = false; // the label's own buffer went unuploaded while the shadow was on
+    std::vector<cocos2d::ccV3F_C4B_T2F_Quad> m_quads; // kept for its capacity
+};
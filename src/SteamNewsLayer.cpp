@@ -1,17 +1,12 @@
 #include "SteamNewsLayer.hpp"
-#include <sstream>
 #include <algorithm>
-#include <regex>
-#include <rapidjson/document.h>
-#include <Geode/utils/web.hpp>
-#include <Geode/loader/Event.hpp>
+#include <chrono>
+#include <utility>
 #include <Geode/loader/Loader.hpp>
 #include <Geode/ui/LoadingSpinner.hpp>
 #include <Geode/ui/Layout.hpp>
-#include <ctime>
 
 using namespace cocos2d;
-using namespace rapidjson;
 using namespace geode::prelude;
 
 bool SteamNewsLayer::init() {
@@ -57,10 +52,27 @@ bool SteamNewsLayer::init() {
     upArrowMenu->setPosition(CCPointZero);
     this->addChild(upArrowMenu, 15);
 
-    fetchNewsItems();
+    // the cells that didn't fit in earlier frames
+    this->schedule(schedule_selector(SteamNewsLayer::onFrame));
+
+    // whatever the feed already has goes on screen right away, without downloading or parsing anything
+    auto& feed = NewsFeed::get();
+    m_subscription = feed.subscribe([this](const NewsFeed::Snapshot& snapshot, steamfeed::FeedChange change, size_t count) {
+        showFeed(snapshot, change, count);
+    });
+    if (!feed.snapshot()->items.empty()) {
+        showFeed(feed.snapshot(), steamfeed::FeedChange::Replaced, feed.snapshot()->items.size());
+    }
+    feed.refresh();
     return true;
 }
 
+void SteamNewsLayer::onFrame(float dt) {
+    if (m_cellsPending) {
+        updateVisibleCells();
+    }
+}
+
 void SteamNewsLayer::scrollToTop(CCObject* sender) {
     if (m_scrollView) {
         m_scrollView->setContentOffset(ccp(0, m_scrollView->getViewSize().height - m_scrollView->getContentSize().height), true);
@@ -72,281 +84,199 @@ void SteamNewsLayer::registerWithTouchDispatcher() {
     touchDispatcher->addTargetedDelegate(this, touchDispatcher->getTargetPrio(), true);
 }
 
+SteamNewsLayer::~SteamNewsLayer() {
+    unsubscribe();
+    CC_SAFE_RELEASE(m_loadingSpinner);
+}
+
+void SteamNewsLayer::unsubscribe() {
+    // the feed keeps loading for the next layer, it just stops telling this one
+    m_subscription.reset();
+    this->unschedule(schedule_selector(SteamNewsLayer::onFrame));
+}
+
+void SteamNewsLayer::keyBackClicked() {
+    closePopup(nullptr);
+}
+
 void SteamNewsLayer::closePopup(CCObject* sender) {
+    unsubscribe();
     this->removeAllChildrenWithCleanup(true);
     this->removeFromParentAndCleanup(true);
 }
 
-void SteamNewsLayer::fetchNewsItems() {
-    geode::log::info("Fetching the SteamNews items...");
+void SteamNewsLayer::loadOlderNewsItems() {
+    if (!m_scrollView) {
+        return;
+    }
+    // the container's bottom edge sits at its offset, the view's at 0
+    float bottom = m_scrollView->getContentOffset().y;
+    if (-bottom > LoadOlderDistance) {
+        return;
+    }
+    // pulling the list up past its end asks again right away, even after a failed page
+    NewsFeed::get().loadOlder(bottom > RetryPullDistance);
+}
 
-    std::string url = "https://api.steampowered.com/ISteamNews/GetNewsForApp/v2/?appid=322170&count=300";
+void SteamNewsLayer::showFeed(const NewsFeed::Snapshot& snapshot, steamfeed::FeedChange change, size_t count) {
+    if (snapshot->items.empty()) {
+        return;
+    }
+    this->removeChild(m_loadingSpinner, true);
 
-    auto req = geode::utils::web::WebRequest();
-    m_listener.bind([this](web::WebTask::Event* e) {
-        if (auto res = e->getValue()) {
-            auto response = res->string().unwrapOr("");
-            if (response.empty()) {
-                return;
-            }
+    float oldHeight = m_feed ? m_feed->layout.totalHeight() : 0;
+    m_feed = snapshot;
+    // the cells copied their text when they were built, nothing on screen changes
+    if (change == steamfeed::FeedChange::Moved) {
+        return;
+    }
+    if (!m_scrollView || change == steamfeed::FeedChange::Replaced) {
+        createScrollView();
+        return;
+    }
 
-            auto newsItems = parseNewsItems(response);
-            Loader::get()->queueInMainThread([this, newsItems]() {
-                this->removeChild(m_loadingSpinner, true); // removing the loading spinner
-                createScrollView(newsItems);
-                });
+    if (change == steamfeed::FeedChange::Resized) {
+        // built again with the longer layout, the cells below only move
+        if (auto resized = m_visibleCells.find(count); resized != m_visibleCells.end()) {
+            m_cellPool.push_back(resized->second);
+            resized->second->removeFromParent();
+            m_visibleCells.erase(resized);
         }
-        });
-
-    auto task = req.get(url);
-    m_listener.setFilter(task);
-}
-
-std::vector<SteamNewsLayer::NewsItem> SteamNewsLayer::parseNewsItems(const std::string& response) {
-    std::vector<NewsItem> newsItems;
-
-    Document document;
-    document.Parse(response.c_str());
-
-    if (!document.HasParseError() && document.IsObject()) {
-        const auto& appNews = document["appnews"];
-        const auto& newsItemsArray = appNews["newsitems"];
-        for (auto& newsItem : newsItemsArray.GetArray()) {
-            NewsItem item;
-            std::string gid = newsItem["gid"].GetString();
-            // skipping duplicate articles based on the gid
-            static const std::set<std::string> skipGids = {
-                "5410576585124650573", "2436926440562370340", "2284879949508460627",
-                "2163281492537211231", "2152021858901922963", "2152021858894636598",
-                "2486412956120074597", "3044845282402408345", "4249665521681179987",
-                "4249665521681180090", "4249665521681180188", "295352659733029280",
-                "377538916270267899", "378660375673380952", "371902438121350491",
-                "405678801273981156", "409053962649582461", "518256108464071258",
-                "517128413774920296", "517127039058316220", "515998514243691390",
-                "517122602985592706", "517122602980080996", "511492468646310449",
-                "521624142113331755"
-            };
-            if (skipGids.find(gid) != skipGids.end()) {
-                continue;
-            }
-            item.gid = gid;
-            item.title = newsItem["title"].GetString();
-            item.content = removeUnwantedParts(newsItem["contents"].GetString(), gid);
-
-            // converting the current date format to readable date
-            if (newsItem.HasMember("date")) {
-                time_t rawTime = newsItem["date"].GetInt64();
-                struct tm* timeInfo = localtime(&rawTime);
-                char buffer[11];
-                strftime(buffer, sizeof(buffer), "%Y-%m-%d", timeInfo);
-                item.date = buffer;
+    }
+    else if (change == steamfeed::FeedChange::Prepended) {
+        // the cells keep their articles, which moved down the list
+        std::unordered_map<size_t, NewsCell*> shifted;
+        for (auto [index, cell] : m_visibleCells) {
+            if (index + count < m_feed->items.size()) {
+                shifted.emplace(index + count, cell);
             }
-
-            if (gid != "5410576585126249016") {
-                newsItems.push_back(item);
+            else {
+                m_cellPool.push_back(cell);
+                cell->removeFromParent();
             }
         }
+        m_visibleCells = std::move(shifted);
     }
 
-    // For reversing the order to show the most recent news on top
-    std::reverse(newsItems.begin(), newsItems.end());
+    auto offset = m_scrollView->getContentOffset();
+    float viewHeight = m_scrollView->getViewSize().height;
+    bool atTop = offset.y <= viewHeight - oldHeight + 1;
+    float newHeight = m_feed->layout.totalHeight();
+    m_scrollView->setContentSize(CCSizeMake(m_scrollView->getContentSize().width, newHeight));
+    for (auto [index, cell] : m_visibleCells) {
+        cell->setPosition(cellPosition(index));
+    }
 
-    return newsItems;
+    if (change == steamfeed::FeedChange::Appended || change == steamfeed::FeedChange::Resized) {
+        // the container grows at the bottom, moving it down as far keeps everything on screen in place
+        m_scrollView->setContentOffset(ccp(offset.x, offset.y - (newHeight - oldHeight)));
+    }
+    else if (atTop) {
+        // a reader at the top gets to see the new articles, anyone further down stays where they were
+        m_scrollView->setContentOffset(ccp(offset.x, viewHeight - newHeight));
+    }
+    updateVisibleCells();
 }
 
-void SteamNewsLayer::createScrollView(const std::vector<NewsItem>& newsItems) {
-    auto scrollLayer = CCLayer::create();
+void SteamNewsLayer::createScrollView() {
     auto winSize = CCDirector::sharedDirector()->getWinSize();
 
-    float totalHeight = 0;
-    for (const auto& item : newsItems) {
-        auto newsItem = createNewsItem(item.title, item.content, item.date);
-        if (newsItem) {
-            size_t newlineCount = std::count(item.content.begin(), item.content.end(), '\n');
-            float spacing = newlineCount >= 5 ? 80 : 40;
-            newsItem->setPosition(ccp(40, totalHeight));
-            totalHeight += newsItem->getContentSize().height + spacing;
-            scrollLayer->addChild(newsItem);
+    if (m_scrollView) {
+        // keeping the cells for the new list
+        for (auto [index, cell] : m_visibleCells) {
+            m_cellPool.push_back(cell);
+            cell->removeFromParent();
         }
+        m_visibleCells.clear();
+        m_scrollView->removeFromParentAndCleanup(true);
+        m_scrollView = nullptr;
     }
 
-    scrollLayer->setContentSize(CCSizeMake(winSize.width, totalHeight));
+    const auto& layout = m_feed->layout;
+    auto scrollLayer = CCLayer::create();
+    scrollLayer->setContentSize(CCSizeMake(winSize.width, layout.totalHeight()));
 
     m_scrollView = cocos2d::extension::CCScrollView::create(winSize, scrollLayer);
     m_scrollView->setDirection(cocos2d::extension::kCCScrollViewDirectionVertical);
     m_scrollView->setPosition(CCPointZero);
-    m_scrollView->setContentOffset(ccp(0, winSize.height - totalHeight));
+    m_scrollView->setContentOffset(ccp(0, winSize.height - layout.totalHeight()));
     m_scrollView->setTouchEnabled(true);
+    m_scrollView->setDelegate(this);
 
     this->addChild(m_scrollView);
+    updateVisibleCells();
 }
 
-CCNode* SteamNewsLayer::createNewsItem(const std::string& title, const std::string& content, const std::string& date) {
-    auto node = CCNode::create();
-    float width = CCDirector::sharedDirector()->getWinSize().width - 150; // For avoiding arrow overlap
-    float height = 50;
-    float padding = 40;
-
-    // Calculating the needed height for the content
-    auto tempLabel = CCLabelBMFont::create(content.c_str(), "chatFont.fnt", width, kCCTextAlignmentLeft);
-    height += tempLabel->getContentSize().height;
-
-    node->setContentSize(CCSizeMake(width, height));
-
-    std::string wrappedTitle = wrapText(title, width - 2 * padding, "goldFont.fnt");
-
-    // Making the title label with a drop shadow
-    auto titleLabel = CCLabelBMFont::create(wrappedTitle.c_str(), "goldFont.fnt");
-    if (titleLabel) {
-        titleLabel->setAnchorPoint(ccp(0, 1));
-        titleLabel->setPosition(ccp(padding, node->getContentSize().height - padding));
-        titleLabel->setScale(0.8);
-
-        auto shadowTitleLabel = CCLabelBMFont::create(wrappedTitle.c_str(), "goldFont.fnt");
-        shadowTitleLabel->setAnchorPoint(ccp(0, 1));
-        shadowTitleLabel->setPosition(ccp(padding + 2, node->getContentSize().height - padding - 2)); // The shadow effect
-        shadowTitleLabel->setScale(0.8);
-        shadowTitleLabel->setColor(ccc3(0, 0, 0));
-        shadowTitleLabel->setOpacity(100);
-
-        node->addChild(shadowTitleLabel, -1); // Placing the shadow behind the title
-        node->addChild(titleLabel);
-    }
-
-    // Calculating the vertical position for the date based on the title's height number
-    float titleHeight = titleLabel->getContentSize().height * titleLabel->getScale();
-    float datePositionY = node->getContentSize().height - padding - titleHeight - 10;
-
-    // Making the date label
-    auto dateLabel = CCLabelBMFont::create(date.c_str(), "bigFont.fnt");
-    if (dateLabel) {
-        dateLabel->setAnchorPoint(ccp(0, 1));
-        dateLabel->setPosition(ccp(padding, datePositionY)); // To position it below the title
-        dateLabel->setScale(0.4);
-        dateLabel->setOpacity(128);
-
-        auto shadowDateLabel = CCLabelBMFont::create(date.c_str(), "bigFont.fnt");
-        shadowDateLabel->setAnchorPoint(ccp(0, 1));
-        shadowDateLabel->setPosition(ccp(padding + 2, datePositionY - 2)); // The shadow effect
-        shadowDateLabel->setScale(0.4);
-        shadowDateLabel->setColor(ccc3(0, 0, 0));
-        shadowDateLabel->setOpacity(100);
-
-        node->addChild(shadowDateLabel, -1); // Put the shadow behind the given date
-        node->addChild(dateLabel);
-    }
-
-    // Adjustment for the content position based on the line count inside each title and date
-    size_t titleLines = std::count(wrappedTitle.begin(), wrappedTitle.end(), '\n') + 1;
-    float contentYOffset = 80 + (titleLines - 1) * 20;
-    contentYOffset -= 20; // To maintain their original position
-
-    // Make the Content label with drop shadow
-    auto contentLabel = CCLabelBMFont::create(content.c_str(), "chatFont.fnt", width, kCCTextAlignmentLeft);
-    if (contentLabel) {
-        contentLabel->setAnchorPoint(ccp(0, 1));
-        contentLabel->setPosition(ccp(padding, node->getContentSize().height - padding - contentYOffset));
-        contentLabel->setScale(0.8);
-
-        auto shadowContentLabel = CCLabelBMFont::create(content.c_str(), "chatFont.fnt", width, kCCTextAlignmentLeft);
-        shadowContentLabel->setAnchorPoint(ccp(0, 1));
-        shadowContentLabel->setPosition(ccp(padding + 2, node->getContentSize().height - padding - contentYOffset - 2)); // The shadow effect
-        shadowContentLabel->setScale(0.8);
-        shadowContentLabel->setColor(ccc3(0, 0, 0));
-        shadowContentLabel->setOpacity(100);
-
-        node->addChild(shadowContentLabel, -1); // Place the shadow behind the content
-        node->addChild(contentLabel);
-    }
-
-    return node;
+void SteamNewsLayer::scrollViewDidScroll(cocos2d::extension::CCScrollView* view) {
+    updateVisibleCells();
+    loadOlderNewsItems();
 }
 
-std::string SteamNewsLayer::removeUnwantedParts(const std::string& text, const std::string& gid) {
-    std::string result = text;
-    size_t pos;
-
-    // The removed portions of text
-    while ((pos = result.find("previewyoutube=")) != std::string::npos) {
-        size_t endPos = result.find(" ", pos);
-        result.erase(pos, endPos - pos + 1);
+void SteamNewsLayer::updateVisibleCells() {
+    if (!m_scrollView) {
+        m_cellsPending = false;
+        return;
     }
 
-    while ((pos = result.find("url=")) != std::string::npos) {
-        size_t endPos = result.find(" ", pos);
-        result.erase(pos, endPos - pos + 1);
-    }
-    while ((pos = result.find("/url")) != std::string::npos) {
-        size_t endPos = result.find(" ", pos);
-        result.erase(pos, endPos - pos + 1);
-    }
-
-    // Removing [, and ]
-    result.erase(std::remove(result.begin(), result.end(), '['), result.end());
-    result.erase(std::remove(result.begin(), result.end(), ']'), result.end());
-
-    // Removing the occurrence of "/list"
-    while ((pos = result.find("/list")) != std::string::npos) {
-        result.erase(pos, 5);
-    }
+    // the container moves down as the view scrolls up, the list is measured down from its top
+    const auto& layout = m_feed->layout;
+    float viewHeight = m_scrollView->getViewSize().height;
+    float fromTop = layout.totalHeight() + m_scrollView->getContentOffset().y - viewHeight;
+    auto visible = layout.list().visibleRange(fromTop, fromTop + viewHeight, VisibleMargin);
 
-    // Removing duplicate article with gid "5218041989051270041"
-    if (gid == "5218041989051270041") {
-        result.erase(std::remove(result.begin(), result.end(), '/'), result.end());
-    }
-
-    // Removing duplicate article with gid "5124585319850001325"
-    if (gid == "5124585319850001325") {
-        while ((pos = result.find("[img]{STEAM_CLAN_IMAGE}/7432088/4fcada2e76dd5b2839d84e420a53315d8e078f98.png")) != std::string::npos) {
-            result.erase(pos, 74);
+    for (auto it = m_visibleCells.begin(); it != m_visibleCells.end();) {
+        if (visible.contains(it->first)) {
+            ++it;
+            continue;
         }
+        m_cellPool.push_back(it->second);
+        it->second->removeFromParent();
+        it = m_visibleCells.erase(it);
     }
 
-    // Replacing the words "/Ru" or "/Rub" with "/RubRub" for full text string.
-    std::istringstream stream(result);
-    std::string word;
-    std::string finalResult;
+    auto container = m_scrollView->getContainer();
+    auto start = std::chrono::steady_clock::now();
+    int built = 0;
+    // top down, the view opens on the newest articles
+    for (auto index = visible.first; index < visible.last; index++) {
+        if (m_visibleCells.contains(index)) {
+            continue;
+        }
+        // at least one cell a frame, the rest once the budget allows
+        if (built > 0 && std::chrono::steady_clock::now() - start > CellBuildBudget) {
+            m_cellsPending = true;
+            return;
+        }
 
-    while (stream >> word) {
-        if (word.find("/Ru") != std::string::npos || word.find("/Rub") != std::string::npos) {
-            word = "/RubRub";
+        geode::Ref<NewsCell> cell;
+        if (m_cellPool.empty()) {
+            cell = NewsCell::create(NewsCell::feedWidth(), [this](NewsCell* cell) { expandArticle(cell); });
+        }
+        else {
+            cell = std::move(m_cellPool.back());
+            m_cellPool.pop_back();
         }
-        finalResult += word + " ";
-    }
 
-    // Trimmed trailing spacing.
-    if (!finalResult.empty()) {
-        finalResult.pop_back();
+        const auto& item = m_feed->items[index];
+        cell->setArticle(layout, index, item.title, item.content, item.date);
+        cell->setPosition(cellPosition(index));
+        container->addChild(cell);
+        m_visibleCells.emplace(index, cell.data());
+        built++;
     }
-
-    return finalResult;
+    m_cellsPending = false;
 }
 
-std::string SteamNewsLayer::wrapText(const std::string& text, float maxWidth, const char* fontFile) {
-    std::stringstream wrappedText;
-    std::stringstream lineStream;
-    std::istringstream wordStream(text);
-    std::string word;
-    float lineWidth = 0;
-    float buffer = -100;  // Setting the buffer for longer lines before wrapping happens.
-
-    while (wordStream >> word) {
-        auto tempLabel = CCLabelBMFont::create(word.c_str(), fontFile);
-        float wordWidth = tempLabel->getContentSize().width;
-        tempLabel->cleanup();
-        tempLabel->release();
-
-        if (lineWidth + wordWidth + buffer > maxWidth) {
-            wrappedText << lineStream.str() << '\n';
-            lineStream.str("");
-            lineWidth = 0;
+void SteamNewsLayer::expandArticle(NewsCell* cell) {
+    for (auto [index, visible] : m_visibleCells) {
+        if (visible == cell) {
+            NewsFeed::get().expand(index);
+            return;
         }
-
-        lineStream << word << ' ';
-        lineWidth += wordWidth;
     }
+}
 
-    wrappedText << lineStream.str();
-
-    return wrappedText.str();
+CCPoint SteamNewsLayer::cellPosition(size_t index) const {
+    const auto& list = m_feed->layout.list();
+    return ccp(40, list.totalHeight() - list.offset(index) - list.height(index));
 }
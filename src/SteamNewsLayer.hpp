@@ -2,44 +2,72 @@
 
 #include <Geode/loader/Log.hpp>
 #include <Geode/modify/FLAlertLayer.hpp>
+#include <chrono>
 #include <cocos2d.h>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
-#include <rapidjson/document.h>
-#include <Geode/utils/web.hpp>
-#include <Geode/loader/Event.hpp>
 #include <Geode/ui/LoadingSpinner.hpp>
+#include <Geode/utils/cocos.hpp>
+#include "NewsCell.hpp"
+#include "NewsFeed.hpp"
+#include "core/FeedStore.hpp"
+#include "core/NewsItem.hpp"
+#include "core/NewsItemView.hpp"
 
 class SteamNewsLayer : public FLAlertLayer, public cocos2d::extension::CCScrollViewDelegate {
 public:
+    ~SteamNewsLayer();
     virtual bool init() override;
     void closePopup(cocos2d::CCObject* sender);
-    void fetchNewsItems();
     void scrollToTop(CCObject* sender);
 
-    struct NewsItem {
-        std::string gid;
-        std::string title;
-        std::string content;
-        std::string date;
-    };
+    using NewsItem = steamfeed::NewsItem;
+    using NewsItemView = steamfeed::NewsItemView;
 
     CREATE_FUNC(SteamNewsLayer);
 
 protected:
     virtual void registerWithTouchDispatcher() override;
+    virtual void keyBackClicked() override;
 
 private:
-    std::vector<NewsItem> parseNewsItems(const std::string& response);
-    void createScrollView(const std::vector<NewsItem>& newsItems);
-    cocos2d::CCNode* createNewsItem(const std::string& title, const std::string& content, const std::string& date);
-    std::string removeUnwantedParts(const std::string& text, const std::string& gid);
-    std::string wrapText(const std::string& text, float maxWidth, const char* fontFile);
-
-    geode::EventListener<geode::utils::web::WebTask> m_listener;
-    geode::LoadingSpinner* m_loadingSpinner;
+    // Asks the feed for the next older page once the reader nears the bottom
+    void loadOlderNewsItems();
+    // Puts a new snapshot of the feed on screen, keeping the cells and the scroll position
+    // of whatever the change left where it was
+    void showFeed(const NewsFeed::Snapshot& snapshot, steamfeed::FeedChange change, size_t count);
+    // Sizes the scroll view to the feed's layout and builds the cells for the part of it that is in view
+    void createScrollView();
+    // Moves cells that scrolled out of view over to the articles that scrolled in, building
+    // new ones only for as long as the frame budget allows
+    void updateVisibleCells();
+    // Lays out the rest of the article a cell shows a preview of, for every layer showing the feed
+    void expandArticle(NewsCell* cell);
+    // Where a cell's bottom left goes in the scroll view's container
+    cocos2d::CCPoint cellPosition(size_t index) const;
+    // Stops listening to the feed, nothing reaches the layer after it
+    void unsubscribe();
+    void onFrame(float dt);
+
+    // how far past the edges of the view cells are kept around, so a fling doesn't show gaps
+    static constexpr float VisibleMargin = 200;
+    // how close the bottom of the list gets to the bottom of the view before older news loads
+    static constexpr float LoadOlderDistance = 600;
+    // how far the list has to be pulled up past its end to retry a page that failed
+    static constexpr float RetryPullDistance = 40;
+    // main thread time a frame may spend building cells, the rest waits for the next frame
+    static constexpr std::chrono::microseconds CellBuildBudget{4000};
+
+    geode::LoadingSpinner* m_loadingSpinner = nullptr;
+    NewsFeed::Subscription m_subscription;
+    NewsFeed::Snapshot m_feed;  // what is on screen, the articles newest first and their layout
     cocos2d::extension::CCScrollView* m_scrollView = nullptr;  // for tracking the scroll view currently
+    std::unordered_map<size_t, NewsCell*> m_visibleCells;  // article index -> cell, children of the scroll view
+    std::vector<geode::Ref<NewsCell>> m_cellPool;  // cells waiting to be handed a new article
+    bool m_cellsPending = false;  // the view still has articles without a cell
 
-    virtual void scrollViewDidScroll(cocos2d::extension::CCScrollView* view) override {}
+    virtual void scrollViewDidScroll(cocos2d::extension::CCScrollView* view) override;
     virtual void scrollViewDidZoom(cocos2d::extension::CCScrollView* view) override {}
 };
@@ -0,0 +1,91 @@
+#include "DateFormatter.hpp"
+#include <cstring>
+#include <ctime>
+
+namespace steamfeed {
+
+namespace {
+    constexpr std::int64_t SecondsPerDay = 86400;
+
+    std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+        return value / divisor - (value % divisor < 0);
+    }
+
+    // Days since 1970-01-01 of a proleptic Gregorian date, and back (Howard Hinnant's algorithms)
+    std::int64_t daysFromCivil(std::int64_t year, unsigned month, unsigned day) {
+        year -= month <= 2;
+        std::int64_t era = floorDiv(year, 400);
+        auto yearOfEra = static_cast<unsigned>(year - era * 400);
+        unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + static_cast<std::int64_t>(dayOfEra) - 719468;
+    }
+
+    void civilFromDays(std::int64_t days, std::int64_t& year, unsigned& month, unsigned& day) {
+        days += 719468;
+        std::int64_t era = floorDiv(days, 146097);
+        auto dayOfEra = static_cast<unsigned>(days - era * 146097);
+        unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        unsigned shifted = (5 * dayOfYear + 2) / 153;
+        day = dayOfYear - (153 * shifted + 2) / 5 + 1;
+        month = shifted < 10 ? shifted + 3 : shifted - 9;
+        year = static_cast<std::int64_t>(yearOfEra) + era * 400 + (month <= 2);
+    }
+
+    void writeDigits(char* out, unsigned value, int digits) {
+        for (int i = digits - 1; i >= 0; i--) {
+            out[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+    }
+}
+
+std::int64_t DateFormatter::offsetAt(std::int64_t timestamp) {
+    std::time_t rawTime = static_cast<std::time_t>(timestamp);
+    std::tm local{};
+#ifdef _WIN32
+    if (localtime_s(&local, &rawTime) != 0) {
+        return 0;
+    }
+#else
+    if (!localtime_r(&rawTime, &local)) {
+        return 0;
+    }
+#endif
+    // the broken down local time read back as if it were UTC, tm_gmtoff isn't everywhere
+    auto days = daysFromCivil(local.tm_year + 1900, static_cast<unsigned>(local.tm_mon + 1), static_cast<unsigned>(local.tm_mday));
+    return days * SecondsPerDay + local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec - timestamp;
+}
+
+void DateFormatter::lookUpOffset(std::int64_t timestamp) {
+    m_offset = offsetAt(timestamp);
+    m_offsetTo = timestamp;
+    // a change somewhere in the window, only the timestamp itself is known
+    m_offsetFrom = offsetAt(timestamp - OffsetWindow) == m_offset ? timestamp - OffsetWindow : timestamp;
+}
+
+void DateFormatter::format(std::int64_t timestamp, char* out) {
+    if (timestamp < m_offsetFrom || timestamp > m_offsetTo) {
+        lookUpOffset(timestamp);
+    }
+
+    auto day = floorDiv(timestamp + m_offset, SecondsPerDay);
+    if (!m_haveDay || day != m_day) {
+        std::int64_t year;
+        unsigned month, dayOfMonth;
+        civilFromDays(day, year, month, dayOfMonth);
+        // what strftime's %Y gives for the years a feed can hold
+        writeDigits(m_text, static_cast<unsigned>(year < 0 ? 0 : year > 9999 ? 9999 : year), 4);
+        m_text[4] = '-';
+        writeDigits(m_text + 5, month, 2);
+        m_text[7] = '-';
+        writeDigits(m_text + 8, dayOfMonth, 2);
+        m_text[10] = '\0';
+        m_day = day;
+        m_haveDay = true;
+    }
+    std::memcpy(out, m_text, NewsDateSize);
+}
+
+}
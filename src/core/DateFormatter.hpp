@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace steamfeed {
+
+// "YYYY-MM-DD" and its '\0'
+constexpr std::size_t NewsDateSize = 11;
+
+// Turns article timestamps into the local date shown under their titles. The UTC offset found
+// for one timestamp is kept for the stretch of time it's been checked to hold over, so the
+// articles around it only take arithmetic, and the last day's text is kept as it is.
+// Nothing is shared between formatters, one per thread.
+class DateFormatter {
+public:
+    // Writes NewsDateSize chars at out
+    void format(std::int64_t timestamp, char* out);
+
+private:
+    // How far back from a timestamp its offset gets checked. Articles come newest first, and
+    // no time zone changes its offset twice within this, so matching ends mean none in between.
+    static constexpr std::int64_t OffsetWindow = 28 * 86400;
+
+    // The offset at timestamp, from the C library, and the local date with it
+    static std::int64_t offsetAt(std::int64_t timestamp);
+    void lookUpOffset(std::int64_t timestamp);
+
+    std::int64_t m_offset = 0;
+    std::int64_t m_offsetFrom = 1; // [from, to] the offset holds over, empty until the first lookup
+    std::int64_t m_offsetTo = 0;
+    std::int64_t m_day = 0;        // local days since 1970-01-01 m_text holds
+    bool m_haveDay = false;
+    char m_text[NewsDateSize] = {};
+};
+
+}
@@ -0,0 +1,64 @@
+#include "FeedPager.hpp"
+#include "NewsApi.hpp"
+#include <algorithm>
+
+namespace steamfeed {
+
+FeedPager::FeedPager(Fetch fetch, int pageSize) : m_fetch(std::move(fetch)), m_pageSize(pageSize) {}
+
+bool FeedPager::requestOlder(std::int64_t oldestTimestamp, Clock::time_point now) {
+    // one page at a time, the next one starts where this one ends
+    if (m_exhausted || !m_inFlight.empty() || backingOff(now)) {
+        return false;
+    }
+
+    // the articles the owner dropped off the last page still moved the feed along
+    auto from = m_cursor != 0 ? std::min(oldestTimestamp, m_cursor) : oldestTimestamp;
+    auto url = newsUrl(m_pageSize, from);
+    if (!m_inFlight.start(url)) {
+        return false;
+    }
+    m_requestedFrom = from;
+    m_fetch(url);
+    return true;
+}
+
+void FeedPager::pageLoaded(const std::string& url, std::size_t received, std::int64_t oldestReceived) {
+    if (!m_inFlight.contains(url)) {
+        return; // from before a reset
+    }
+    m_inFlight.finish(url);
+    m_failures = 0;
+    m_retryAt = {};
+    if (received < static_cast<std::size_t>(m_pageSize)) {
+        m_exhausted = true;
+        return;
+    }
+    // a full page all dated the second it started at would come back the same every time,
+    // the rest of that second is given up on to get past it
+    m_cursor = oldestReceived < m_requestedFrom || m_requestedFrom == 0 ? oldestReceived : m_requestedFrom - 1;
+}
+
+void FeedPager::pageFailed(const std::string& url, Clock::time_point now) {
+    if (!m_inFlight.contains(url)) {
+        return; // from before a reset, cancelled along with it
+    }
+    m_inFlight.finish(url);
+    m_failures++;
+    auto delay = FirstRetryDelay * (1 << std::min(m_failures - 1, 5));
+    m_retryAt = now + std::min<Clock::duration>(delay, LongestRetryDelay);
+}
+
+void FeedPager::retry() {
+    m_retryAt = {};
+}
+
+void FeedPager::reset() {
+    m_inFlight.clear();
+    m_exhausted = false;
+    m_cursor = 0;
+    m_failures = 0;
+    m_retryAt = {};
+}
+
+}
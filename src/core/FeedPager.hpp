@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_set>
+
+namespace steamfeed {
+
+// Requests that are on their way, so asking again for the same one is a no-op until it's back
+class InFlightRequests {
+public:
+    // false when key is already in flight
+    bool start(const std::string& key) { return m_keys.insert(key).second; }
+    void finish(const std::string& key) { m_keys.erase(key); }
+    void clear() { m_keys.clear(); }
+
+    bool contains(const std::string& key) const { return m_keys.contains(key); }
+    bool empty() const { return m_keys.empty(); }
+
+private:
+    std::unordered_set<std::string> m_keys;
+};
+
+// Walks the feed back in pages with the API's enddate as the reader scrolls down. The fetch
+// is injected, the owner reports every page back by its url, and a page already on its way
+// isn't asked for again however often the scroll view wants more in the meantime. Neither is
+// one that just failed, scrolling only asks again once a delay that grows with every failure
+// in a row is up.
+class FeedPager {
+public:
+    using Clock = std::chrono::steady_clock;
+    // Starts loading url, the result goes to pageLoaded or pageFailed
+    using Fetch = std::function<void(const std::string& url)>;
+
+    // the wait after the first failure, doubling up to the longest
+    static constexpr std::chrono::seconds FirstRetryDelay{ 2 };
+    static constexpr std::chrono::seconds LongestRetryDelay{ 60 };
+
+    FeedPager(Fetch fetch, int pageSize);
+
+    // The page reaching back from oldestTimestamp (inclusive, the boundary articles come
+    // again and are the owner's to drop), or from further back when the last page's oldest
+    // articles were all dropped. False when nothing was started because it's already
+    // loading, the last page failed too recently or the feed ran out.
+    bool requestOlder(std::int64_t oldestTimestamp, Clock::time_point now = Clock::now());
+    // received is how many articles the response held before the owner dropped anything and
+    // oldestReceived the oldest of their dates. A page short of the page size ends the feed,
+    // a full one of nothing but reposts doesn't.
+    void pageLoaded(const std::string& url, std::size_t received, std::int64_t oldestReceived);
+    // The page can be asked for again once the retry delay is up
+    void pageFailed(const std::string& url, Clock::time_point now = Clock::now());
+    // Lets the next request through right away, for when the reader asks for the page
+    // themselves. Failures still count towards the delay after the next one.
+    void retry();
+    // Forgets the end of the feed and any failures and drops the pages in flight, for when the
+    // feed is replaced. Their results still come back and have to be ignored by the owner.
+    void reset();
+
+    bool loading() const { return !m_inFlight.empty(); }
+    bool exhausted() const { return m_exhausted; }
+    bool backingOff(Clock::time_point now = Clock::now()) const { return now < m_retryAt; }
+    // Whether url is a page the pager is still waiting for
+    bool pending(const std::string& url) const { return m_inFlight.contains(url); }
+
+private:
+    Fetch m_fetch;
+    int m_pageSize;
+    InFlightRequests m_inFlight;
+    bool m_exhausted = false;
+    std::int64_t m_requestedFrom = 0; // the enddate of the page in flight
+    std::int64_t m_cursor = 0;        // where the next page starts at the latest, 0 for no limit
+    int m_failures = 0;          // in a row, since the last page that loaded
+    Clock::time_point m_retryAt; // no request before this
+};
+
+}
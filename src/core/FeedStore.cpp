@@ -0,0 +1,190 @@
+#include "FeedStore.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace steamfeed {
+
+FeedStore::FeedStore() : m_snapshot(std::make_shared<FeedSnapshot>()) {}
+
+FeedStore::Subscription FeedStore::subscribe(Listener listener) {
+    auto subscription = m_nextSubscription++;
+    m_listeners.emplace(subscription, std::move(listener));
+    return subscription;
+}
+
+void FeedStore::unsubscribe(Subscription subscription) {
+    m_listeners.erase(subscription);
+}
+
+void FeedStore::replace(std::vector<NewsItem> items, NewsLayout layout) {
+    auto owner = std::make_shared<const std::vector<NewsItem>>(std::move(items));
+    auto views = viewsOf(*owner);
+    replace(std::move(views), std::move(owner), std::move(layout));
+}
+
+void FeedStore::prepend(std::vector<NewsItem> items, const NewsLayout& layout, std::size_t limit) {
+    auto owner = std::make_shared<const std::vector<NewsItem>>(std::move(items));
+    auto views = viewsOf(*owner);
+    prepend(std::move(views), std::move(owner), layout, limit);
+}
+
+void FeedStore::append(std::vector<NewsItem> items, const NewsLayout& layout) {
+    auto owner = std::make_shared<const std::vector<NewsItem>>(std::move(items));
+    auto views = viewsOf(*owner);
+    append(std::move(views), std::move(owner), layout);
+}
+
+void FeedStore::replace(std::vector<NewsItemView> items, std::shared_ptr<const void> owner, NewsLayout layout) {
+    auto next = std::make_shared<FeedSnapshot>();
+    next->items = std::move(items);
+    next->layout = std::move(layout);
+    next->owners.push_back(std::move(owner));
+    next->itemOwners.assign(next->items.size(), 0);
+    auto count = next->items.size();
+    publish(std::move(next), FeedChange::Replaced, count);
+}
+
+void FeedStore::prepend(std::vector<NewsItemView> items, std::shared_ptr<const void> owner, const NewsLayout& layout, std::size_t limit) {
+    if (items.empty()) {
+        return;
+    }
+    const auto& current = *m_snapshot;
+    auto next = std::make_shared<FeedSnapshot>();
+    next->items = std::move(items);
+    next->layout = layout;
+    auto count = next->items.size();
+    next->owners.push_back(std::move(owner));
+    next->itemOwners.assign(count, 0);
+
+    // the layout's lines are offsets into the text, so they carry over to the shared articles as they are
+    for (std::size_t i = 0; i < current.items.size() && next->items.size() < limit; i++) {
+        next->items.push_back(current.items[i]);
+        next->layout.append(current.layout, i);
+        next->itemOwners.push_back(current.itemOwners[i] + 1);
+    }
+    next->owners.insert(next->owners.end(), current.owners.begin(), current.owners.end());
+    // the oldest articles falling off may have been the last in their page
+    compactOwners(*next);
+    publish(std::move(next), FeedChange::Prepended, count);
+}
+
+void FeedStore::append(std::vector<NewsItemView> items, std::shared_ptr<const void> owner, const NewsLayout& layout) {
+    if (items.empty()) {
+        return;
+    }
+    auto next = std::make_shared<FeedSnapshot>(*m_snapshot);
+    // a stream's later batches have the same owner as its first
+    if (next->owners.empty() || next->owners.back() != owner) {
+        next->owners.push_back(std::move(owner));
+    }
+    auto ownerIndex = static_cast<std::uint32_t>(next->owners.size() - 1);
+    for (std::size_t i = 0; i < items.size(); i++) {
+        next->items.push_back(items[i]);
+        next->layout.append(layout, i);
+        next->itemOwners.push_back(ownerIndex);
+    }
+    publish(std::move(next), FeedChange::Appended, items.size());
+}
+
+void FeedStore::relayout(std::size_t index, NewsLayout layout) {
+    auto next = std::make_shared<FeedSnapshot>();
+    next->items = m_snapshot->items;
+    next->layout = std::move(layout);
+    next->owners = m_snapshot->owners;
+    next->itemOwners = m_snapshot->itemOwners;
+    publish(std::move(next), FeedChange::Resized, index);
+}
+
+void FeedStore::detach(const std::shared_ptr<const void>& owner) {
+    const auto& current = *m_snapshot;
+    auto found = std::find(current.owners.begin(), current.owners.end(), owner);
+    // a cache that never mapped hands out a null owner, which no article points into
+    if (!owner || found == current.owners.end()) {
+        return;
+    }
+    auto ownerIndex = static_cast<std::uint32_t>(found - current.owners.begin());
+    auto copies = std::make_shared<std::vector<NewsItem>>();
+    for (std::size_t i = 0; i < current.items.size(); i++) {
+        if (current.itemOwners[i] == ownerIndex) {
+            copies->push_back(toNewsItem(current.items[i]));
+        }
+    }
+
+    // the same text, so the layout's offsets into it still hold
+    auto views = viewsOf(*copies);
+    auto next = std::make_shared<FeedSnapshot>(current);
+    for (std::size_t i = 0, copied = 0; i < next->items.size(); i++) {
+        if (next->itemOwners[i] == ownerIndex) {
+            next->items[i] = views[copied++];
+        }
+    }
+    next->owners[ownerIndex] = std::move(copies);
+    publish(std::move(next), FeedChange::Moved, views.size());
+}
+
+void FeedStore::compactOwners(FeedSnapshot& snapshot) {
+    constexpr auto Unused = static_cast<std::uint32_t>(-1);
+    std::vector<std::uint32_t> remap(snapshot.owners.size(), Unused);
+    for (auto index : snapshot.itemOwners) {
+        remap[index] = 0;
+    }
+    std::uint32_t kept = 0;
+    for (std::size_t i = 0; i < snapshot.owners.size(); i++) {
+        if (remap[i] == Unused) {
+            continue;
+        }
+        if (kept != i) {
+            snapshot.owners[kept] = std::move(snapshot.owners[i]);
+        }
+        remap[i] = kept++;
+    }
+    snapshot.owners.resize(kept);
+    for (auto& index : snapshot.itemOwners) {
+        index = remap[index];
+    }
+}
+
+void FeedStore::publish(std::shared_ptr<FeedSnapshot> next, FeedChange change, std::size_t count) {
+    next->version = m_snapshot->version + 1;
+    m_snapshot = std::move(next);
+
+    // listeners may unsubscribe themselves or each other while this runs
+    std::vector<Subscription> subscriptions;
+    for (const auto& [subscription, listener] : m_listeners) {
+        subscriptions.push_back(subscription);
+    }
+    auto snapshot = m_snapshot;
+    for (auto subscription : subscriptions) {
+        auto listener = m_listeners.find(subscription);
+        if (listener != m_listeners.end()) {
+            // a copy, the listener may be erased while it runs
+            auto call = listener->second;
+            call(snapshot, change, count);
+        }
+    }
+}
+
+FeedSubscription::FeedSubscription(FeedStore& store, FeedStore::Listener listener)
+    : m_store(&store), m_subscription(store.subscribe(std::move(listener))) {}
+
+FeedSubscription::FeedSubscription(FeedSubscription&& other) noexcept
+    : m_store(std::exchange(other.m_store, nullptr)), m_subscription(std::exchange(other.m_subscription, 0)) {}
+
+FeedSubscription& FeedSubscription::operator=(FeedSubscription&& other) noexcept {
+    if (this != &other) {
+        reset();
+        m_store = std::exchange(other.m_store, nullptr);
+        m_subscription = std::exchange(other.m_subscription, 0);
+    }
+    return *this;
+}
+
+void FeedSubscription::reset() {
+    if (m_store) {
+        m_store->unsubscribe(m_subscription);
+        m_store = nullptr;
+        m_subscription = 0;
+    }
+}
+
+}
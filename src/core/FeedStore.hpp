@@ -0,0 +1,106 @@
+#pragma once
+
+#include "NewsItem.hpp"
+#include "NewsItemView.hpp"
+#include "NewsLayout.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace steamfeed {
+
+// The feed at one point in time, as every open view sees it. Nothing in it changes once
+// it's published, a later state is a new snapshot that shares the articles of this one.
+struct FeedSnapshot {
+    std::vector<NewsItemView> items; // newest first, pointing into owners
+    NewsLayout layout;               // of items, in the same order
+    std::vector<std::shared_ptr<const void>> owners; // what the views point into, NewsItems or a ParsedFeed
+    std::vector<std::uint32_t> itemOwners;           // per item, its index into owners
+    std::uint64_t version = 0;
+};
+
+// How a snapshot differs from the one before it
+enum class FeedChange {
+    Replaced,  // anything may have changed, views start over
+    Prepended, // newer articles on top, the rest as it was apart from the oldest falling off
+    Appended,  // older articles at the bottom, everything above as it was
+    Resized,   // one article laid out again, everything below it moved
+    Moved,     // the same articles and layout, only the text lives somewhere else now
+};
+
+// Holds the current snapshot of the feed and tells the subscribers whenever it moves on.
+// Main thread only, the snapshots themselves can go anywhere.
+class FeedStore {
+public:
+    using Snapshot = std::shared_ptr<const FeedSnapshot>;
+    // count is how many articles were prepended or appended, the snapshot's size on Replaced,
+    // the article's index on Resized and how many were copied on Moved
+    using Listener = std::function<void(const Snapshot& snapshot, FeedChange change, std::size_t count)>;
+    using Subscription = std::uint64_t;
+
+    FeedStore();
+
+    const Snapshot& snapshot() const { return m_snapshot; }
+    bool empty() const { return m_snapshot->items.empty(); }
+
+    // The listener is called on every change from now on, not with the current snapshot
+    Subscription subscribe(Listener listener);
+    // Safe from inside a listener, the unsubscribed one isn't called again
+    void unsubscribe(Subscription subscription);
+    std::size_t subscribers() const { return m_listeners.size(); }
+
+    // The feed becomes items, laid out as layout
+    void replace(std::vector<NewsItem> items, NewsLayout layout);
+    // Puts newer articles on top, then drops the oldest down to limit
+    void prepend(std::vector<NewsItem> items, const NewsLayout& layout, std::size_t limit);
+    // Adds older articles at the bottom
+    void append(std::vector<NewsItem> items, const NewsLayout& layout);
+
+    // The same for views, owner being whatever keeps their text alive. Batches streamed out
+    // of one parse can share an owner.
+    void replace(std::vector<NewsItemView> items, std::shared_ptr<const void> owner, NewsLayout layout);
+    void prepend(std::vector<NewsItemView> items, std::shared_ptr<const void> owner, const NewsLayout& layout, std::size_t limit);
+    void append(std::vector<NewsItemView> items, std::shared_ptr<const void> owner, const NewsLayout& layout);
+
+    // Swaps in a layout of the same articles that only differs at index
+    void relayout(std::size_t index, NewsLayout layout);
+    // Copies the articles pointing into owner out of it, so the feed lets go of it. Nothing
+    // happens when no article does.
+    void detach(const std::shared_ptr<const void>& owner);
+
+private:
+    // Drops the owners no item points into any more, once articles fell off
+    static void compactOwners(FeedSnapshot& snapshot);
+    void publish(std::shared_ptr<FeedSnapshot> next, FeedChange change, std::size_t count);
+
+    Snapshot m_snapshot;
+    std::map<Subscription, Listener> m_listeners;
+    Subscription m_nextSubscription = 1;
+};
+
+// Owns a subscription to a FeedStore, which has to outlive it. reset() or the destructor
+// unsubscribes, so a view holding one can't be called after it closed or went away.
+class FeedSubscription {
+public:
+    FeedSubscription() = default;
+    FeedSubscription(FeedStore& store, FeedStore::Listener listener);
+    ~FeedSubscription() { reset(); }
+
+    FeedSubscription(FeedSubscription&& other) noexcept;
+    FeedSubscription& operator=(FeedSubscription&& other) noexcept;
+    FeedSubscription(const FeedSubscription&) = delete;
+    FeedSubscription& operator=(const FeedSubscription&) = delete;
+
+    // Unsubscribes now, safe from inside the listener and when there's nothing to unsubscribe
+    void reset();
+    bool active() const { return m_store != nullptr; }
+
+private:
+    FeedStore* m_store = nullptr;
+    FeedStore::Subscription m_subscription = 0;
+};
+
+}
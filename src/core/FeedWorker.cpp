@@ -0,0 +1,106 @@
+#include "FeedWorker.hpp"
+
+namespace steamfeed {
+
+FeedWorker::FeedWorker() : m_thread([this] { run(); }) {}
+
+FeedWorker::~FeedWorker() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+        m_queued.clear();
+        m_onPoll.clear();
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void FeedWorker::post(Job job, Done done) {
+    {
+        std::lock_guard lock(m_mutex);
+        m_queued.push_back({ std::move(job), std::move(done) });
+    }
+    m_wake.notify_one();
+}
+
+void FeedWorker::postOnPoll(Job job, Done done) {
+    std::lock_guard lock(m_mutex);
+    m_onPoll.push_back({ std::move(job), std::move(done) });
+}
+
+void FeedWorker::publish(Done done) {
+    std::lock_guard lock(m_mutex);
+    m_finished.push_back(std::move(done));
+}
+
+std::size_t FeedWorker::poll() {
+    std::deque<Done> finished;
+    {
+        std::lock_guard lock(m_mutex);
+        finished.swap(m_finished);
+    }
+    // outside the lock, completions are free to post the next job
+    for (auto& done : finished) {
+        if (done) {
+            done();
+        }
+    }
+
+    // a single job, it has the owner's thread to itself while it runs
+    Task task;
+    bool taken = false;
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_paused && !m_onPoll.empty()) {
+            task = std::move(m_onPoll.front());
+            m_onPoll.pop_front();
+            taken = true;
+        }
+    }
+    if (taken) {
+        if (task.job) {
+            task.job();
+        }
+        std::lock_guard lock(m_mutex);
+        m_finished.push_back(std::move(task.done));
+    }
+    return finished.size();
+}
+
+bool FeedWorker::idle() {
+    std::lock_guard lock(m_mutex);
+    return m_queued.empty() && m_onPoll.empty() && !m_running && m_finished.empty();
+}
+
+void FeedWorker::setPaused(bool paused) {
+    {
+        std::lock_guard lock(m_mutex);
+        m_paused = paused;
+    }
+    m_wake.notify_one();
+}
+
+void FeedWorker::run() {
+    std::unique_lock lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this] { return m_stopping || (!m_paused && !m_queued.empty()); });
+        if (m_stopping) {
+            return;
+        }
+
+        Task task = std::move(m_queued.front());
+        m_queued.pop_front();
+        m_running = true;
+        lock.unlock();
+        if (task.job) {
+            task.job();
+        }
+        lock.lock();
+        m_running = false;
+        m_finished.push_back(std::move(task.done));
+    }
+}
+
+}
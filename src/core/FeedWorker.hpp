@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace steamfeed {
+
+// A thread of its own for the heavy part of loading a feed (parsing, sanitizing, layout).
+// Jobs run one after another in the order they were posted, and their completions wait
+// until the owner polls for them, so completions always run on the owner's thread (the
+// main thread in the mod) and never after the worker is gone.
+class FeedWorker {
+public:
+    using Job = std::function<void()>;
+    using Done = std::function<void()>;
+
+    FeedWorker();
+    // Drops the jobs that haven't started and waits for the running one, without completing either
+    ~FeedWorker();
+
+    FeedWorker(const FeedWorker&) = delete;
+    FeedWorker& operator=(const FeedWorker&) = delete;
+
+    void post(Job job, Done done);
+    // For a job that has to run on the owner's thread: it runs inside a later poll, one job a
+    // poll and none while paused, its completion waiting for the poll after. Kept in order
+    // among themselves, not against the worker's jobs.
+    void postOnPoll(Job job, Done done);
+    // From inside a job: hands over part of its result early. The completion runs on the
+    // next poll, ahead of the job's own.
+    void publish(Done done);
+    // Runs the completions of every job finished so far, then the next job posted on poll.
+    // Returns how many completions ran.
+    std::size_t poll();
+    // Nothing queued, running or waiting to be completed
+    bool idle();
+    // While paused, queued jobs wait instead of starting. A job that is running already goes on.
+    void setPaused(bool paused);
+
+private:
+    void run();
+
+    struct Task {
+        Job job;
+        Done done;
+    };
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<Task> m_queued;
+    std::deque<Task> m_onPoll;
+    std::deque<Done> m_finished;
+    bool m_running = false;
+    bool m_stopping = false;
+    bool m_paused = false;
+    std::thread m_thread;
+};
+
+}
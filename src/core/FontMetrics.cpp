@@ -0,0 +1,132 @@
+#include "FontMetrics.hpp"
+#include "MappedFile.hpp"
+#include <charconv>
+
+namespace steamfeed {
+
+namespace {
+    // The value of key=value on a .fnt line, 0 when it's missing
+    int attribute(std::string_view line, std::string_view key) {
+        std::size_t pos = 0;
+        while ((pos = line.find(key, pos)) != std::string_view::npos) {
+            auto valueStart = pos + key.size();
+            bool wholeKey = (pos == 0 || line[pos - 1] == ' ') && valueStart < line.size() && line[valueStart] == '=';
+            if (wholeKey) {
+                int value = 0;
+                std::from_chars(line.data() + valueStart + 1, line.data() + line.size(), value);
+                return value;
+            }
+            pos = valueStart;
+        }
+        return 0;
+    }
+
+    // Decodes one UTF-8 sequence, a stray byte comes out as itself
+    std::uint32_t nextCodepoint(std::string_view text, std::size_t& pos) {
+        auto lead = static_cast<unsigned char>(text[pos++]);
+        int extra = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+        if (extra == 0 || pos + extra > text.size()) {
+            return lead;
+        }
+
+        std::uint32_t codepoint = lead & (0x3F >> extra);
+        for (int i = 0; i < extra; i++) {
+            codepoint = codepoint << 6 | (static_cast<unsigned char>(text[pos++]) & 0x3F);
+        }
+        return codepoint;
+    }
+}
+
+bool FontMetrics::parse(std::string_view fnt) {
+    *this = FontMetrics();
+
+    std::size_t start = 0;
+    while (start < fnt.size()) {
+        auto end = fnt.find('\n', start);
+        if (end == std::string_view::npos) {
+            end = fnt.size();
+        }
+        auto line = fnt.substr(start, end - start);
+        start = end + 1;
+
+        if (line.starts_with("char ")) {
+            auto id = static_cast<std::uint32_t>(attribute(line, "id"));
+            auto advance = static_cast<float>(attribute(line, "xadvance"));
+            if (id < m_latin1.size()) {
+                m_latin1[id] = advance;
+            }
+            else {
+                m_wide[id] = advance;
+            }
+            m_glyphs++;
+        }
+        else if (line.starts_with("kerning ")) {
+            auto first = static_cast<std::uint32_t>(attribute(line, "first"));
+            auto second = static_cast<std::uint32_t>(attribute(line, "second"));
+            m_kerning[static_cast<std::uint64_t>(first) << 32 | second] = attribute(line, "amount");
+        }
+        else if (line.starts_with("common ")) {
+            m_lineHeight = attribute(line, "lineHeight");
+        }
+    }
+    return m_glyphs > 0;
+}
+
+bool FontMetrics::loadFile(const std::filesystem::path& path) {
+    MappedFile file;
+    if (!file.open(path)) {
+        *this = FontMetrics();
+        return false;
+    }
+    return parse({ file.data(), file.size() });
+}
+
+float FontMetrics::measure(std::string_view text) const {
+    float width = 0;
+    std::uint32_t previous = 0;
+    for (std::size_t pos = 0; pos < text.size();) {
+        auto codepoint = nextCodepoint(text, pos);
+        width += advance(codepoint);
+        if (previous != 0 && !m_kerning.empty()) {
+            width += static_cast<float>(kerning(previous, codepoint));
+        }
+        previous = codepoint;
+    }
+    return width;
+}
+
+float FontMetrics::advance(std::uint32_t codepoint) const {
+    if (codepoint < m_latin1.size()) {
+        return m_latin1[codepoint];
+    }
+    auto glyph = m_wide.find(codepoint);
+    return glyph != m_wide.end() ? glyph->second : 0.0f;
+}
+
+int FontMetrics::kerning(std::uint32_t first, std::uint32_t second) const {
+    auto pair = m_kerning.find(static_cast<std::uint64_t>(first) << 32 | second);
+    return pair != m_kerning.end() ? pair->second : 0;
+}
+
+float WordWidthCache::measure(const FontMetrics& font, std::string_view word) {
+    auto cached = m_index.find({ &font, word });
+    if (cached != m_index.end()) {
+        m_hits++;
+        m_entries.splice(m_entries.begin(), m_entries, cached->second);
+        return cached->second->width;
+    }
+
+    m_misses++;
+    if (m_entries.size() >= m_capacity && !m_entries.empty()) {
+        const auto& oldest = m_entries.back();
+        m_index.erase({ oldest.font, oldest.word });
+        m_entries.pop_back();
+    }
+
+    m_entries.push_front({ &font, std::string(word), font.measure(word) });
+    const auto& entry = m_entries.front();
+    m_index.emplace(KeyView{ entry.font, entry.word }, m_entries.begin());
+    return entry.width;
+}
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace steamfeed {
+
+// Glyph advances and kerning pairs from a BMFont .fnt (text format) file, enough to measure
+// a run of text the way CCLabelBMFont lays it out without creating a label. Widths are in the
+// font's pixels, divide by the content scale factor to get points.
+class FontMetrics {
+public:
+    // false when the text has no glyphs in it
+    bool parse(std::string_view fnt);
+    bool loadFile(const std::filesystem::path& path);
+
+    // Sum of the advances plus the kerning between neighbours. Glyphs the font doesn't
+    // have take no space, same as in the label.
+    float measure(std::string_view text) const;
+
+    int lineHeight() const { return m_lineHeight; }
+    bool empty() const { return m_glyphs == 0; }
+
+private:
+    float advance(std::uint32_t codepoint) const;
+    int kerning(std::uint32_t first, std::uint32_t second) const;
+
+    // Latin-1 goes through a flat table, the rest (rare in these fonts) through a map
+    std::array<float, 256> m_latin1 = {};
+    std::unordered_map<std::uint32_t, float> m_wide;
+    std::unordered_map<std::uint64_t, int> m_kerning;
+    std::size_t m_glyphs = 0;
+    int m_lineHeight = 0;
+};
+
+// Memoised word widths, least recently used words dropped first. Fonts are told apart by
+// address, so they have to outlive the cache.
+class WordWidthCache {
+public:
+    explicit WordWidthCache(std::size_t capacity = 4096) : m_capacity(capacity) {}
+
+    float measure(const FontMetrics& font, std::string_view word);
+
+    std::size_t size() const { return m_entries.size(); }
+    std::uint64_t hits() const { return m_hits; }
+    std::uint64_t misses() const { return m_misses; }
+
+private:
+    struct Entry {
+        const FontMetrics* font;
+        std::string word;
+        float width;
+    };
+
+    struct KeyView {
+        const FontMetrics* font;
+        std::string_view word;
+        bool operator==(const KeyView&) const = default;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const KeyView& key) const {
+            return std::hash<std::string_view>()(key.word) ^ std::hash<const void*>()(key.font);
+        }
+    };
+
+    std::size_t m_capacity;
+    // front is the most recently used, the index keys view into the entries' own strings
+    std::list<Entry> m_entries;
+    std::unordered_map<KeyView, std::list<Entry>::iterator, KeyHash> m_index;
+    std::uint64_t m_hits = 0;
+    std::uint64_t m_misses = 0;
+};
+
+}
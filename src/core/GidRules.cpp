@@ -0,0 +1,127 @@
+#include "GidRules.hpp"
+#include "MappedFile.hpp"
+#include <charconv>
+#include <utility>
+#include <rapidjson/document.h>
+
+using namespace rapidjson;
+
+namespace steamfeed {
+
+namespace {
+    std::uint64_t parseGid(std::string_view gid) {
+        // up to 19 digits can't overflow, the rare longer one goes through the checked path
+        if (gid.empty() || gid.size() > 19) {
+            std::uint64_t value = 0;
+            auto [end, error] = std::from_chars(gid.data(), gid.data() + gid.size(), value);
+            return error == std::errc() && end == gid.data() + gid.size() ? value : 0;
+        }
+
+        std::uint64_t value = 0;
+        for (char c : gid) {
+            auto digit = static_cast<unsigned>(c - '0');
+            if (digit > 9) {
+                return 0;
+            }
+            value = value * 10 + digit;
+        }
+        return value;
+    }
+}
+
+bool GidRuleTable::load(std::string_view json) {
+    // filled on the side and only swapped in once the whole file checks out, a bad file
+    // leaves the table empty instead of holding the rules read up to the error
+    GidRuleTable table;
+    auto fail = [this] {
+        *this = GidRuleTable();
+        return false;
+    };
+
+    Document document;
+    document.Parse(json.data(), json.size());
+    if (document.HasParseError() || !document.IsObject()) {
+        return fail();
+    }
+
+    const std::pair<const char*, GidRule> lists[] = {
+        { "skip", SkipArticle },
+        { "stripSlashes", StripSlashes }
+    };
+    for (const auto& [name, rule] : lists) {
+        auto list = document.FindMember(name);
+        if (list == document.MemberEnd()) {
+            continue;
+        }
+        if (!list->value.IsArray()) {
+            return fail();
+        }
+        for (const auto& gid : list->value.GetArray()) {
+            std::uint64_t value = gid.IsString() ? parseGid({ gid.GetString(), gid.GetStringLength() }) : 0;
+            if (value == 0) {
+                return fail();
+            }
+            table.add(value, rule);
+        }
+    }
+    *this = std::move(table);
+    return true;
+}
+
+bool GidRuleTable::loadFile(const std::filesystem::path& path) {
+    MappedFile file;
+    if (!file.open(path)) {
+        m_slots.clear();
+        m_count = 0;
+        return false;
+    }
+    return load({ file.data(), file.size() });
+}
+
+std::uint8_t GidRuleTable::rules(std::uint64_t gid) const {
+    if (m_slots.empty() || gid == 0) {
+        return 0;
+    }
+    return m_slots[slotFor(gid)].rules;
+}
+
+std::uint8_t GidRuleTable::rules(std::string_view gid) const {
+    return rules(parseGid(gid));
+}
+
+void GidRuleTable::add(std::uint64_t gid, std::uint8_t rules) {
+    // kept at most half full so probe runs stay short
+    if ((m_count + 1) * 2 > m_slots.size()) {
+        grow();
+    }
+
+    auto& slot = m_slots[slotFor(gid)];
+    if (slot.gid == 0) {
+        slot.gid = gid;
+        m_count++;
+    }
+    slot.rules |= rules;
+}
+
+void GidRuleTable::grow() {
+    auto old = std::move(m_slots);
+    m_slots.assign(old.empty() ? 64 : old.size() * 2, Slot());
+    for (const auto& slot : old) {
+        if (slot.gid != 0) {
+            m_slots[slotFor(slot.gid)] = slot;
+        }
+    }
+}
+
+// The slot holding gid, or the empty one where it would go. Gids from the same batch of
+// posts share most of their digits, so they are mixed before picking a slot.
+std::size_t GidRuleTable::slotFor(std::uint64_t gid) const {
+    auto mask = m_slots.size() - 1;
+    auto index = static_cast<std::size_t>((gid * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    while (m_slots[index].gid != 0 && m_slots[index].gid != gid) {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace steamfeed {
+
+// What to do with a specific article, as bits so one gid can carry several rules
+enum GidRule : std::uint8_t {
+    SkipArticle = 1 << 0,  // duplicates and posts that don't belong in the feed
+    StripSlashes = 1 << 1  // removes every '/' from the contents
+};
+
+// Per-article rules keyed by the numeric gid, loaded from the gid_rules.json resource so
+// they can change without a rebuild. Lookups are a single probe into a flat open-addressing
+// table; gid 0 marks an empty slot, Steam never hands that one out.
+class GidRuleTable {
+public:
+    // {"skip": ["gid", ...], "stripSlashes": ["gid", ...]}, false when the JSON is malformed.
+    // Replaces whatever was loaded before either way, with an empty table on failure.
+    bool load(std::string_view json);
+    bool loadFile(const std::filesystem::path& path);
+
+    std::uint8_t rules(std::uint64_t gid) const;
+    // gids come as strings in the API, one that isn't a number has no rules
+    std::uint8_t rules(std::string_view gid) const;
+
+    std::size_t size() const { return m_count; }
+
+private:
+    struct Slot {
+        std::uint64_t gid = 0;
+        std::uint8_t rules = 0;
+    };
+
+    void add(std::uint64_t gid, std::uint8_t rules);
+    void grow();
+    std::size_t slotFor(std::uint64_t gid) const;
+
+    std::vector<Slot> m_slots;
+    std::size_t m_count = 0;
+};
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace steamfeed {
+
+// What a response can be revalidated with later, the headers exactly as the server sent them
+struct HttpValidators {
+    std::string etag;         // ETag, quotes and all
+    std::string lastModified; // Last-Modified
+
+    bool empty() const { return etag.empty() && lastModified.empty(); }
+};
+
+// The headers that turn a GET into "only if it changed since", a 304 without a body otherwise.
+// Servers go by If-None-Match when both are there, the date is for the ones without ETags.
+inline std::vector<std::pair<std::string, std::string>> conditionalHeaders(const HttpValidators& validators) {
+    std::vector<std::pair<std::string, std::string>> headers;
+    if (!validators.etag.empty()) {
+        headers.emplace_back("If-None-Match", validators.etag);
+    }
+    if (!validators.lastModified.empty()) {
+        headers.emplace_back("If-Modified-Since", validators.lastModified);
+    }
+    return headers;
+}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace steamfeed {
+
+constexpr int GeometryDashAppId = 322170;
+// the most articles the layer keeps, older pages stop loading past it
+constexpr int FullFeedCount = 300;
+// what a cold start shows before the reader scrolls
+constexpr int FirstPageCount = 20;
+// enough to reach back past the newest cached article on a refresh
+constexpr int RefreshPageCount = 20;
+// loaded each time the reader nears the bottom
+constexpr int OlderPageCount = 30;
+
+// endDate limits the page to articles from that unix time or before, 0 for the newest
+inline std::string newsUrl(int count, std::int64_t endDate = 0) {
+    std::string url = "https://api.steampowered.com/ISteamNews/GetNewsForApp/v2/?appid=" + std::to_string(GeometryDashAppId)
+        + "&count=" + std::to_string(count);
+    if (endDate > 0) {
+        url += "&enddate=" + std::to_string(endDate);
+    }
+    return url;
+}
+
+}
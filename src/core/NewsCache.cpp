@@ -0,0 +1,201 @@
+#include "NewsCache.hpp"
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_set>
+
+namespace steamfeed {
+
+namespace {
+    // "SFNC", the format version and the item count, then one ItemHeader per item and the
+    // string blob. Offsets are relative to the blob and every string ends in a '\0'.
+    struct FileHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t count;
+        std::uint32_t reserved;
+        std::uint64_t blobSize;
+    };
+
+    constexpr char Magic[4] = { 'S', 'F', 'N', 'C' };
+    // 3: items newest first
+    constexpr std::uint32_t Version = 3;
+
+    // only the headers are read here, the blob's pages wait until an article is
+    bool inBlob(std::uint32_t offset, std::uint32_t size, std::uint64_t blobSize) {
+        return static_cast<std::uint64_t>(offset) + size < blobSize;
+    }
+
+    // The views handed out promise a '\0' right after each string. Checked as an article is
+    // read rather than on open, a damaged string comes out empty.
+    std::string_view terminated(const char* blob, std::uint32_t offset, std::uint32_t size) {
+        return blob[offset + size] == '\0' ? std::string_view(blob + offset, size) : std::string_view("", 0);
+    }
+}
+
+bool NewsCache::open(const std::filesystem::path& path) {
+    m_path = path;
+    return map(m_path);
+}
+
+bool NewsCache::map(const std::filesystem::path& path) {
+    m_file.reset();
+    m_headers = nullptr;
+    m_blob = nullptr;
+    m_count = 0;
+
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path) || file->size() < sizeof(FileHeader)) {
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version) {
+        return false;
+    }
+
+    // subtract from what's there rather than add up the header's sizes, a crafted blobSize can't wrap
+    auto headersSize = static_cast<std::uint64_t>(header.count) * sizeof(ItemHeader);
+    std::uint64_t available = file->size() - sizeof(FileHeader);
+    if (headersSize > available || header.blobSize != available - headersSize || header.blobSize == 0) {
+        return false;
+    }
+
+    auto headers = reinterpret_cast<const ItemHeader*>(file->data() + sizeof(FileHeader));
+    auto blob = file->data() + sizeof(FileHeader) + headersSize;
+    // the one page at the end, so a string running off the end of the blob still stops
+    if (blob[header.blobSize - 1] != '\0') {
+        return false;
+    }
+    for (std::uint32_t i = 0; i < header.count; i++) {
+        const auto& item = headers[i];
+        if (!inBlob(item.gid, item.gidSize, header.blobSize) || !inBlob(item.title, item.titleSize, header.blobSize)
+            || !inBlob(item.content, item.contentSize, header.blobSize) || !inBlob(item.date, item.dateSize, header.blobSize)) {
+            return false;
+        }
+    }
+
+    m_file = std::move(file);
+    m_headers = headers;
+    m_blob = blob;
+    m_count = header.count;
+    return true;
+}
+
+NewsItemView NewsCache::operator[](std::size_t index) const {
+    const auto& item = m_headers[index];
+    return {
+        terminated(m_blob, item.gid, item.gidSize),
+        terminated(m_blob, item.title, item.titleSize),
+        terminated(m_blob, item.content, item.contentSize),
+        terminated(m_blob, item.date, item.dateSize),
+        item.timestamp
+    };
+}
+
+std::vector<NewsItemView> NewsCache::items() const {
+    std::vector<NewsItemView> views;
+    views.reserve(m_count);
+    for (std::size_t i = 0; i < m_count; i++) {
+        views.push_back((*this)[i]);
+    }
+    return views;
+}
+
+bool NewsCache::store(const std::vector<NewsItemView>& items) {
+    std::vector<ItemHeader> headers(items.size());
+    std::string blob;
+
+    auto append = [&blob](std::string_view value, std::uint32_t& offset, std::uint32_t& size) {
+        offset = static_cast<std::uint32_t>(blob.size());
+        size = static_cast<std::uint32_t>(value.size());
+        blob += value;
+        blob += '\0';
+    };
+    for (std::size_t i = 0; i < items.size(); i++) {
+        auto& header = headers[i];
+        header.timestamp = items[i].timestamp;
+        append(items[i].gid, header.gid, header.gidSize);
+        append(items[i].title, header.title, header.titleSize);
+        append(items[i].content, header.content, header.contentSize);
+        append(items[i].date, header.date, header.dateSize);
+    }
+    if (blob.empty()) {
+        blob += '\0';
+    }
+
+    FileHeader fileHeader = {};
+    std::memcpy(fileHeader.magic, Magic, sizeof(Magic));
+    fileHeader.version = Version;
+    fileHeader.count = static_cast<std::uint32_t>(items.size());
+    fileHeader.blobSize = blob.size();
+
+    // written next to the cache and swapped in, so a crash mid-write keeps the old one
+    auto tempPath = m_path;
+    tempPath += ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+        file.write(reinterpret_cast<const char*>(headers.data()), static_cast<std::streamsize>(headers.size() * sizeof(ItemHeader)));
+        file.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+        if (!file.flush()) {
+            return false;
+        }
+    }
+
+    // the old mapping has to go first, Windows refuses to replace a mapped file. It's only
+    // unmapped once whoever else holds it lets go.
+    m_file.reset();
+    std::error_code error;
+    std::filesystem::rename(tempPath, m_path, error);
+    if (error) {
+        map(m_path);
+        return false;
+    }
+    return map(m_path);
+}
+
+bool mergeNewerItems(std::vector<NewsItemView>& cached, const std::vector<NewsItemView>& fresh,
+    std::vector<std::size_t>* taken) {
+    if (taken) {
+        taken->clear();
+    }
+    if (cached.empty()) {
+        cached = fresh;
+        for (std::size_t i = 0; taken && i < fresh.size(); i++) {
+            taken->push_back(i);
+        }
+        return true;
+    }
+    if (fresh.empty()) {
+        return true;
+    }
+
+    std::int64_t newest = cached.front().timestamp;
+    // the oldest article of the page is still newer than the cache, articles in between are missing
+    if (fresh.back().timestamp > newest) {
+        return false;
+    }
+
+    // articles sharing the newest timestamp may already be cached
+    std::unordered_set<std::string_view> newestGids;
+    for (auto it = cached.begin(); it != cached.end() && it->timestamp == newest; ++it) {
+        newestGids.insert(it->gid);
+    }
+
+    std::vector<NewsItemView> newer;
+    for (std::size_t i = 0; i < fresh.size(); i++) {
+        const auto& item = fresh[i];
+        if (item.timestamp > newest || (item.timestamp == newest && !newestGids.count(item.gid))) {
+            newer.push_back(item);
+            if (taken) {
+                taken->push_back(i);
+            }
+        }
+    }
+    cached.insert(cached.begin(), newer.begin(), newer.end());
+    return true;
+}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "MappedFile.hpp"
+#include "NewsItemView.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace steamfeed {
+
+// The parsed feed as a memory-mapped file, so the layer can show the last feed the
+// moment it opens. Fixed-size item headers hold offsets into one string blob and the
+// articles are handed out as views straight into the mapping, so opening the cache
+// costs the headers plus whatever pages the caller actually reads. Items are kept in
+// layer order (newest first).
+class NewsCache {
+public:
+    // Maps the file, false when it is missing, from another format version or damaged.
+    // The path is kept for store() either way.
+    bool open(const std::filesystem::path& path);
+
+    bool empty() const { return m_count == 0; }
+    std::size_t size() const { return m_count; }
+    NewsItemView operator[](std::size_t index) const;
+    std::vector<NewsItemView> items() const;
+    // Keeps the mapping the views point into alive, past a store() as well. Null when nothing is mapped.
+    std::shared_ptr<const void> owner() const { return m_file; }
+
+    // Writes the items (which may point into this cache's own mapping) and maps the result.
+    // Views taken from the cache before the call only stay valid while their owner() is held,
+    // but Windows won't replace a mapped file, so there the store fails until it's let go.
+    // On failure the cache holds the old contents if it could map them back.
+    bool store(const std::vector<NewsItemView>& items);
+
+private:
+    bool map(const std::filesystem::path& path);
+
+    struct ItemHeader {
+        std::int64_t timestamp;
+        std::uint32_t gid, gidSize;
+        std::uint32_t title, titleSize;
+        std::uint32_t content, contentSize;
+        std::uint32_t date, dateSize;
+    };
+
+    std::filesystem::path m_path;
+    std::shared_ptr<const MappedFile> m_file;
+    const ItemHeader* m_headers = nullptr;
+    const char* m_blob = nullptr;
+    std::size_t m_count = 0;
+};
+
+// Puts the articles from a refresh page that are newer than everything cached in front,
+// both lists in layer order. Returns false when the page never reached back to the cached
+// articles, so there may be a gap and a full refresh is needed instead. taken, when given,
+// gets the indices into fresh of the articles that went in front, in order.
+bool mergeNewerItems(std::vector<NewsItemView>& cached, const std::vector<NewsItemView>& fresh,
+    std::vector<std::size_t>* taken = nullptr);
+
+}
@@ -0,0 +1,173 @@
+#include "NewsDedup.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace steamfeed {
+
+namespace {
+    constexpr std::uint64_t FnvOffset = 14695981039346656037ull;
+    constexpr std::uint64_t FnvPrime = 1099511628211ull;
+
+    std::uint64_t mix(std::uint64_t hash, std::uint64_t value) {
+        return (std::rotl(hash, 5) ^ value) * 0x9E3779B97F4A7C15ull;
+    }
+
+    bool isWordChar(unsigned char c) {
+        // anything outside ASCII is part of a UTF-8 sequence, kept as it is
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+    }
+
+    // Calls onWord with the FNV-1a hash of every lowercased word outside the [tags]
+    template <class F>
+    void forEachWord(std::string_view text, F&& onWord) {
+        std::uint64_t hash = FnvOffset;
+        bool inWord = false;
+        bool inTag = false;
+        for (char ch : text) {
+            auto c = static_cast<unsigned char>(ch);
+            if (inTag) {
+                inTag = c != ']';
+                continue;
+            }
+            if (isWordChar(c)) {
+                if (c >= 'A' && c <= 'Z') {
+                    c = static_cast<unsigned char>(c - 'A' + 'a');
+                }
+                hash = (hash ^ c) * FnvPrime;
+                inWord = true;
+                continue;
+            }
+            if (inWord) {
+                onWord(hash);
+                hash = FnvOffset;
+                inWord = false;
+            }
+            inTag = c == '[';
+        }
+        if (inWord) {
+            onWord(hash);
+        }
+    }
+
+    // byte j of s_spread[b] is bit j of b
+    constexpr auto s_spread = [] {
+        std::array<std::uint64_t, 256> spread = {};
+        for (unsigned b = 0; b < 256; b++) {
+            for (int bit = 0; bit < 8; bit++) {
+                spread[b] |= static_cast<std::uint64_t>(b >> bit & 1) << (bit * 8);
+            }
+        }
+        return spread;
+    }();
+
+    // Counts how often each of the 64 bits is set across the features. Eight bits at a time
+    // go into byte-sized counters packed in a word, which get flushed before they can overflow.
+    class SimHashCounter {
+    public:
+        void add(std::uint64_t feature) {
+            for (int i = 0; i < 8; i++) {
+                m_packed[i] += s_spread[feature >> (i * 8) & 0xFF];
+            }
+            if (++m_pending == 255) {
+                flush();
+            }
+        }
+
+        // bits set in more than half of the features
+        std::uint64_t hash() {
+            flush();
+            std::uint64_t hash = 0;
+            for (int bit = 0; bit < 64; bit++) {
+                if (2 * m_counts[bit] > m_total) {
+                    hash |= 1ull << bit;
+                }
+            }
+            return hash;
+        }
+
+    private:
+        void flush() {
+            for (int i = 0; i < 8; i++) {
+                for (int j = 0; j < 8; j++) {
+                    m_counts[i * 8 + j] += m_packed[i] >> (j * 8) & 0xFF;
+                }
+                m_packed[i] = 0;
+            }
+            m_total += m_pending;
+            m_pending = 0;
+        }
+
+        std::uint64_t m_packed[8] = {};
+        std::uint32_t m_counts[64] = {};
+        std::uint32_t m_total = 0;
+        std::uint32_t m_pending = 0;
+    };
+
+    std::uint32_t bandKey(int band, std::uint64_t simHash) {
+        return static_cast<std::uint32_t>(band) << 8 | static_cast<std::uint8_t>(simHash >> (band * 8));
+    }
+}
+
+NewsFingerprint fingerprintNews(std::string_view title, std::string_view content) {
+    NewsFingerprint fingerprint;
+    SimHashCounter counter;
+    std::uint64_t exact = FnvOffset;
+    std::uint64_t previous = 0;
+    std::uint64_t beforePrevious = 0;
+
+    auto onWord = [&](std::uint64_t word) {
+        exact = mix(exact, word);
+        fingerprint.words++;
+
+        // runs of three words rather than single words, so the same vocabulary in a different order differs
+        counter.add(mix(mix(beforePrevious, previous), word));
+        beforePrevious = previous;
+        previous = word;
+    };
+    forEachWord(title, onWord);
+    exact = mix(exact, 0); // so words can't move between the title and the contents
+    forEachWord(content, onWord);
+
+    fingerprint.exact = exact;
+    fingerprint.simHash = counter.hash();
+    return fingerprint;
+}
+
+NewsDedup::NewsDedup(int maxDistance, std::pmr::memory_resource* memory)
+    : m_maxDistance(std::clamp(maxDistance, 0, Bands - 1)), m_exact(memory), m_bands(memory) {}
+
+bool NewsDedup::isDuplicate(std::string_view title, std::string_view content) {
+    return isDuplicate(fingerprintNews(title, content));
+}
+
+bool NewsDedup::isDuplicate(const NewsFingerprint& fingerprint) {
+    if (!m_exact.insert(fingerprint.exact).second) {
+        return true;
+    }
+    if (m_maxDistance == 0 || fingerprint.words < NearDuplicateMinWords) {
+        return false;
+    }
+
+    // Hashes at most maxDistance bits apart share at least one of the eight bands exactly,
+    // so only the articles in those buckets need a full comparison
+    for (int band = 0; band < Bands; band++) {
+        auto [begin, end] = m_bands.equal_range(bandKey(band, fingerprint.simHash));
+        for (auto it = begin; it != end; ++it) {
+            if (std::popcount(it->second ^ fingerprint.simHash) <= m_maxDistance) {
+                return true;
+            }
+        }
+    }
+    for (int band = 0; band < Bands; band++) {
+        m_bands.emplace(bandKey(band, fingerprint.simHash), fingerprint.simHash);
+    }
+    return false;
+}
+
+void NewsDedup::clear() {
+    m_exact.clear();
+    m_bands.clear();
+}
+
+}
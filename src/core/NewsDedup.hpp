@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace steamfeed {
+
+// Fingerprints of an article's normalised text: lowercased words with the BBCode tags,
+// punctuation and whitespace between them dropped, so reposts that only differ in markup
+// or formatting hash the same
+struct NewsFingerprint {
+    std::uint64_t exact = 0;   // title and contents word for word
+    std::uint64_t simHash = 0; // over runs of three words, a few flipped bits for a small edit
+    std::uint32_t words = 0;
+};
+
+NewsFingerprint fingerprintNews(std::string_view title, std::string_view content);
+
+// Drops the repeats of articles Steam hands out under several gids, in one pass as they
+// come out of the parser: the first copy seen (the newest, in API order) is kept. Longer
+// articles also count as repeats when their SimHashes are close, which catches reposts
+// with a fixed typo or a changed link.
+class NewsDedup {
+public:
+    // How many SimHash bits may differ for two articles to be the same one, 0 for exact repeats only.
+    // Found through eight 8 bit bands of the hash, so it can't go past 7. One inserted word stays
+    // within 6 bits about 95% of the time, unrelated articles sit around 32 bits apart.
+    static constexpr int DefaultMaxDistance = 6;
+    // memory is where the tables go, a ScratchArena's for the length of a refresh
+    explicit NewsDedup(int maxDistance = DefaultMaxDistance, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    // false the first time an article is seen, true for every repeat of it after that
+    bool isDuplicate(std::string_view title, std::string_view content);
+    bool isDuplicate(const NewsFingerprint& fingerprint);
+
+    void clear();
+
+private:
+    // short posts have too few words for the SimHash distance to mean anything
+    static constexpr std::uint32_t NearDuplicateMinWords = 32;
+    static constexpr int Bands = 8;
+
+    int m_maxDistance;
+    std::pmr::unordered_set<std::uint64_t> m_exact;
+    // band index and its 8 bits -> SimHashes of the articles kept so far
+    std::pmr::unordered_multimap<std::uint32_t, std::uint64_t> m_bands;
+};
+
+}
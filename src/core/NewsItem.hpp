@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace steamfeed {
+
+// A single article from ISteamNews/GetNewsForApp
+struct NewsItem {
+    std::string gid;
+    std::string title;
+    std::string content;
+    std::string date;
+    std::int64_t timestamp = 0; // unix time the date string was formatted from
+    std::uint8_t rules = 0;     // GidRule bits for this article, only needed until it is sanitized
+};
+
+}
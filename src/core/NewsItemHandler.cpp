@@ -0,0 +1,147 @@
+#include "NewsItemHandler.hpp"
+
+namespace steamfeed {
+
+bool NewsItemPath::inItem() const {
+    return m_depth == ItemDepth
+        && !m_isArray[1] && m_keys[1] == Field::AppNews
+        && !m_isArray[2] && m_keys[2] == Field::NewsItems
+        && m_isArray[3] && !m_isArray[4];
+}
+
+bool NewsItemPath::startObject() {
+    m_depth++;
+    if (m_depth <= ItemDepth) {
+        m_isArray[m_depth] = false;
+        m_keys[m_depth] = Field::Other;
+    }
+    return inItem();
+}
+
+bool NewsItemPath::endObject() {
+    bool item = inItem();
+    m_depth--;
+    return item;
+}
+
+void NewsItemPath::startArray() {
+    m_depth++;
+    if (m_depth <= ItemDepth) {
+        m_isArray[m_depth] = true;
+        m_keys[m_depth] = Field::Other;
+    }
+}
+
+void NewsItemPath::endArray() {
+    m_depth--;
+}
+
+void NewsItemPath::key(std::string_view key) {
+    if (m_depth > ItemDepth) {
+        return;
+    }
+
+    auto& slot = m_keys[m_depth];
+    switch (m_depth) {
+        case 1: slot = key == "appnews" ? Field::AppNews : Field::Other; break;
+        case 2: slot = key == "newsitems" ? Field::NewsItems : Field::Other; break;
+        case ItemDepth:
+            if (key == "gid") slot = Field::Gid;
+            else if (key == "title") slot = Field::Title;
+            else if (key == "contents") slot = Field::Contents;
+            else if (key == "date") slot = Field::Date;
+            else slot = Field::Other;
+            break;
+        default: slot = Field::Other; break;
+    }
+}
+
+bool NewsItemHandler::StartObject() {
+    if (m_path.startObject()) {
+        m_item = NewsItem();
+        m_hasDate = false;
+    }
+    return true;
+}
+
+bool NewsItemHandler::EndObject(rapidjson::SizeType) {
+    return m_path.endObject() ? emitItem() : true;
+}
+
+bool NewsItemHandler::String(const char* str, rapidjson::SizeType length, bool) {
+    switch (m_path.field()) {
+        case NewsItemPath::Field::Gid: m_item.gid.assign(str, length); break;
+        case NewsItemPath::Field::Title: m_item.title.assign(str, length); break;
+        case NewsItemPath::Field::Contents: m_item.content.assign(str, length); break;
+        default: break;
+    }
+    return true;
+}
+
+bool NewsItemHandler::number(std::int64_t value) {
+    if (m_path.field() == NewsItemPath::Field::Date) {
+        m_item.timestamp = value;
+        m_hasDate = true;
+    }
+    return true;
+}
+
+bool NewsItemHandler::emitItem() {
+    m_item.rules = m_rules.rules(m_item.gid);
+    if (m_item.rules & SkipArticle) {
+        return true;
+    }
+
+    if (m_hasDate) {
+        char date[NewsDateSize];
+        m_dates.format(m_item.timestamp, date);
+        m_item.date = date;
+    }
+
+    return m_sink(std::move(m_item));
+}
+
+bool InSituNewsItemHandler::StartObject() {
+    if (m_path.startObject()) {
+        // empty but '\0' terminated, for fields the article doesn't have
+        m_item = RawNewsItem();
+        m_item.view = { "", "", "", "", 0 };
+    }
+    return true;
+}
+
+bool InSituNewsItemHandler::EndObject(rapidjson::SizeType) {
+    return m_path.endObject() ? emitItem() : true;
+}
+
+bool InSituNewsItemHandler::String(const char* str, rapidjson::SizeType length, bool) {
+    switch (m_path.field()) {
+        case NewsItemPath::Field::Gid: m_item.view.gid = { str, length }; break;
+        case NewsItemPath::Field::Title: m_item.view.title = { str, length }; break;
+        case NewsItemPath::Field::Contents: m_item.view.content = { str, length }; break;
+        default: break;
+    }
+    return true;
+}
+
+bool InSituNewsItemHandler::number(std::int64_t value) {
+    if (m_path.field() == NewsItemPath::Field::Date) {
+        m_item.view.timestamp = value;
+        m_item.hasDate = true;
+    }
+    return true;
+}
+
+bool InSituNewsItemHandler::emitItem() {
+    if (m_received == 0 || m_item.view.timestamp < m_oldestReceived) {
+        m_oldestReceived = m_item.view.timestamp;
+    }
+    m_received++;
+    m_item.rules = m_rules.rules(m_item.view.gid);
+    if (m_item.rules & SkipArticle) {
+        return true;
+    }
+    return m_sink(m_item);
+}
+
+}
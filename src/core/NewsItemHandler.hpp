@@ -0,0 +1,120 @@
+#pragma once
+
+#include "DateFormatter.hpp"
+#include "GidRules.hpp"
+#include "NewsItem.hpp"
+#include "NewsItemView.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <rapidjson/reader.h>
+
+namespace steamfeed {
+
+// Called for every article as it streams out of the parser, return false to stop parsing
+using NewsItemSink = std::function<bool(NewsItem&& item)>;
+
+// An article straight out of the in-situ handler, its strings pointing into the buffer being parsed
+struct RawNewsItem {
+    NewsItemView view;     // without a date, the buffer has no room for one
+    std::uint8_t rules = 0;
+    bool hasDate = false;
+};
+using RawNewsItemSink = std::function<bool(RawNewsItem& item)>;
+
+// Where the reader is in a GetNewsForApp response. Only appnews.newsitems[*].{gid,title,contents,date}
+// matter, everything else streams past.
+class NewsItemPath {
+public:
+    enum class Field : std::uint8_t { Other, AppNews, NewsItems, Gid, Title, Contents, Date };
+
+    // true when the object starting is an article
+    bool startObject();
+    // true when the object ending is an article
+    bool endObject();
+    void startArray();
+    void endArray();
+    void key(std::string_view key);
+
+    // The article field the next value belongs to, Other anywhere outside an article's own fields
+    Field field() const { return inItem() ? m_keys[ItemDepth] : Field::Other; }
+
+private:
+    // appnews -> newsitems -> [ {article} ], so articles sit at depth 4
+    static constexpr int ItemDepth = 4;
+
+    bool inItem() const;
+
+    int m_depth = 0;
+    // what the enclosing containers are, only tracked down to the article fields
+    bool m_isArray[ItemDepth + 1] = {};
+    Field m_keys[ItemDepth + 1] = {};
+};
+
+// SAX handler for GetNewsForApp responses, copying the fields it keeps, so it works over any
+// stream. The current article is the only one held in memory before it is handed to the sink.
+// Articles the rule table skips never reach it.
+class NewsItemHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, NewsItemHandler> {
+public:
+    NewsItemHandler(const NewsItemSink& sink, const GidRuleTable& rules) : m_sink(sink), m_rules(rules) {}
+
+    bool StartObject();
+    bool EndObject(rapidjson::SizeType memberCount);
+    bool StartArray() { m_path.startArray(); return true; }
+    bool EndArray(rapidjson::SizeType) { m_path.endArray(); return true; }
+    bool Key(const char* str, rapidjson::SizeType length, bool) { m_path.key({ str, length }); return true; }
+    bool String(const char* str, rapidjson::SizeType length, bool copy);
+    bool Int(int value) { return number(value); }
+    bool Uint(unsigned value) { return number(value); }
+    bool Int64(int64_t value) { return number(value); }
+    bool Uint64(uint64_t value) { return number(static_cast<std::int64_t>(value)); }
+    bool Default() { return true; }
+
+private:
+    bool number(std::int64_t value);
+    bool emitItem();
+
+    const NewsItemSink& m_sink;
+    const GidRuleTable& m_rules;
+    NewsItemPath m_path;
+    NewsItem m_item;
+    bool m_hasDate = false;
+    DateFormatter m_dates;
+};
+
+// The same for kParseInsituFlag, where the reader decodes every string inside the buffer and
+// ends it with a '\0'. Articles come out as views into the buffer, nothing gets copied.
+class InSituNewsItemHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, InSituNewsItemHandler> {
+public:
+    InSituNewsItemHandler(const RawNewsItemSink& sink, const GidRuleTable& rules) : m_sink(sink), m_rules(rules) {}
+
+    // Every article read so far, the skipped ones included, and the oldest of their dates
+    std::size_t received() const { return m_received; }
+    std::int64_t oldestReceived() const { return m_oldestReceived; }
+
+    bool StartObject();
+    bool EndObject(rapidjson::SizeType memberCount);
+    bool StartArray() { m_path.startArray(); return true; }
+    bool EndArray(rapidjson::SizeType) { m_path.endArray(); return true; }
+    bool Key(const char* str, rapidjson::SizeType length, bool) { m_path.key({ str, length }); return true; }
+    bool String(const char* str, rapidjson::SizeType length, bool copy);
+    bool Int(int value) { return number(value); }
+    bool Uint(unsigned value) { return number(value); }
+    bool Int64(int64_t value) { return number(value); }
+    bool Uint64(uint64_t value) { return number(static_cast<std::int64_t>(value)); }
+    bool Default() { return true; }
+
+private:
+    bool number(std::int64_t value);
+    bool emitItem();
+
+    const RawNewsItemSink& m_sink;
+    const GidRuleTable& m_rules;
+    NewsItemPath m_path;
+    RawNewsItem m_item;
+    std::size_t m_received = 0;
+    std::int64_t m_oldestReceived = 0;
+};
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "NewsItem.hpp"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace steamfeed {
+
+// Non-owning article, pointing into the mapped news cache, a ParsedFeed's buffer or into
+// NewsItems that outlive it. Every string is followed by a '\0', so data() can go straight to C APIs.
+struct NewsItemView {
+    std::string_view gid;
+    std::string_view title;
+    std::string_view content;
+    std::string_view date;
+    std::int64_t timestamp = 0;
+};
+
+inline NewsItemView viewOf(const NewsItem& item) {
+    return { item.gid, item.title, item.content, item.date, item.timestamp };
+}
+
+inline std::vector<NewsItemView> viewsOf(const std::vector<NewsItem>& items) {
+    std::vector<NewsItemView> views;
+    views.reserve(items.size());
+    for (const auto& item : items) {
+        views.push_back(viewOf(item));
+    }
+    return views;
+}
+
+inline NewsItem toNewsItem(const NewsItemView& view) {
+    return { std::string(view.gid), std::string(view.title), std::string(view.content), std::string(view.date), view.timestamp };
+}
+
+}
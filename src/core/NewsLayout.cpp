@@ -0,0 +1,220 @@
+#include "NewsLayout.hpp"
+
+namespace steamfeed {
+
+namespace {
+    bool isSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    // Same rule as wrapText: words measured on their own, spaces not counted
+    constexpr float TitleBuffer = -100;
+
+    // From the old createNewsItem
+    constexpr float BaseHeight = 50;
+    constexpr float DateGap = 10;
+    constexpr float ContentGap = 60;
+    constexpr float TitleLineStep = 20;
+    constexpr std::size_t LongArticleNewlines = 5;
+
+    // articles per chunk handed to the pool
+    constexpr std::size_t ParallelGrain = 32;
+}
+
+NewsLayout::NewsLayout(NewsLayoutStyle style) : m_style(std::move(style)) {
+    if (m_style.content.measure) {
+        m_contentSpace = m_style.content.measure(" ");
+    }
+}
+
+void NewsLayout::clear() {
+    m_articles.clear();
+    m_lines.clear();
+    m_list.clear();
+}
+
+const ArticleLayout& NewsLayout::append(std::string_view title, std::string_view content) {
+    ArticleLayout& article = m_articles.emplace_back(layoutArticle(title, content, m_style.previewLines));
+    m_list.append(article.height, article.spacing);
+    return article;
+}
+
+const ArticleLayout& NewsLayout::expand(std::size_t index, std::string_view title, std::string_view content) {
+    // the new lines go on the end, the preview's are left behind unused until the layout is copied
+    ArticleLayout& article = m_articles[index];
+    article = layoutArticle(title, content, 0);
+    m_list.resize(index, article.height, article.spacing);
+    return article;
+}
+
+ArticleLayout NewsLayout::layoutArticle(std::string_view title, std::string_view content, std::uint32_t maxContentLines) {
+    ArticleLayout article;
+    article.firstLine = static_cast<std::uint32_t>(m_lines.size());
+    article.titleLines = wrapTitle(title);
+    std::size_t newlines = 0;
+    article.contentLines = wrapContent(content, maxContentLines, newlines, article.truncated);
+
+    // the content label's height never had its scale applied, the cells were always sized like that
+    const auto& style = m_style;
+    article.height = BaseHeight + static_cast<float>(article.contentLines) * style.content.lineHeight;
+    article.spacing = newlines >= LongArticleNewlines ? 80.0f : 40.0f;
+    article.titleTop = article.height - style.padding;
+
+    float titleHeight = static_cast<float>(article.titleLines) * style.title.lineHeight * style.title.scale;
+    article.dateTop = article.titleTop - titleHeight - DateGap;
+    float titleExtra = article.titleLines > 0 ? static_cast<float>(article.titleLines - 1) * TitleLineStep : 0.0f;
+    article.contentTop = article.titleTop - ContentGap - titleExtra;
+    return article;
+}
+
+const ArticleLayout& NewsLayout::append(const NewsLayout& other, std::size_t index) {
+    auto lines = other.titleLines(index);
+    ArticleLayout& article = m_articles.emplace_back(other[index]);
+    article.firstLine = static_cast<std::uint32_t>(m_lines.size());
+    m_lines.insert(m_lines.end(), lines.data(), lines.data() + article.titleLines + article.contentLines);
+
+    m_list.append(article.height, article.spacing);
+    return article;
+}
+
+void NewsLayout::append(std::span<const NewsItemView> items, TaskPool& pool) {
+    // each chunk gets a layout of its own, put together in order once they're all done
+    std::size_t chunks = (items.size() + ParallelGrain - 1) / ParallelGrain;
+    std::vector<NewsLayout> parts(chunks, NewsLayout(m_style));
+    pool.parallelFor(items.size(), ParallelGrain, [&](std::size_t begin, std::size_t end) {
+        auto& part = parts[begin / ParallelGrain];
+        for (auto i = begin; i < end; i++) {
+            part.append(items[i].title, items[i].content);
+        }
+    });
+
+    m_articles.reserve(m_articles.size() + items.size());
+    for (const auto& part : parts) {
+        for (std::size_t i = 0; i < part.size(); i++) {
+            append(part, i);
+        }
+    }
+}
+
+std::span<const LayoutLine> NewsLayout::titleLines(std::size_t index) const {
+    const auto& article = m_articles[index];
+    return { m_lines.data() + article.firstLine, article.titleLines };
+}
+
+std::span<const LayoutLine> NewsLayout::contentLines(std::size_t index) const {
+    const auto& article = m_articles[index];
+    return { m_lines.data() + article.firstLine + article.titleLines, article.contentLines };
+}
+
+std::uint32_t NewsLayout::wrapTitle(std::string_view title) {
+    float maxWidth = m_style.width - 2 * m_style.padding;
+    auto firstLine = m_lines.size();
+    LayoutLine line;
+    bool lineOpen = false;
+    float lineWidth = 0;
+
+    std::size_t pos = 0;
+    while (pos < title.size()) {
+        if (isSpace(title[pos])) {
+            pos++;
+            continue;
+        }
+        auto end = pos;
+        while (end < title.size() && !isSpace(title[end])) {
+            end++;
+        }
+
+        float wordWidth = m_style.title.measure(title.substr(pos, end - pos));
+        if (lineWidth + wordWidth + TitleBuffer > maxWidth) {
+            // wrapText breaks before the first word too, which comes out as a blank first line
+            m_lines.push_back(line);
+            line = { static_cast<std::uint32_t>(pos), static_cast<std::uint32_t>(pos) };
+            lineWidth = 0;
+        }
+        else if (!lineOpen) {
+            line.begin = static_cast<std::uint32_t>(pos);
+        }
+        lineOpen = true;
+        line.end = static_cast<std::uint32_t>(end);
+        lineWidth += wordWidth;
+        pos = end;
+    }
+    m_lines.push_back(line);
+    return static_cast<std::uint32_t>(m_lines.size() - firstLine);
+}
+
+std::uint32_t NewsLayout::wrapContent(std::string_view content, std::uint32_t maxLines, std::size_t& newlines, bool& truncated) {
+    // the label wraps in its scaled space
+    const auto& font = m_style.content;
+    float maxWidth = font.scale > 0 ? m_style.width / font.scale : m_style.width;
+    auto firstLine = m_lines.size();
+    // checked before every line, so the rest of the content is never looked at
+    auto full = [&] {
+        truncated = maxLines > 0 && m_lines.size() - firstLine >= maxLines;
+        return truncated;
+    };
+
+    std::size_t paragraph = 0;
+    while (true) {
+        auto paragraphEnd = content.find('\n', paragraph);
+        if (paragraphEnd == std::string_view::npos) {
+            paragraphEnd = content.size();
+        }
+
+        // greedy, breaking in front of the word that would stick out
+        LayoutLine line = { static_cast<std::uint32_t>(paragraph), static_cast<std::uint32_t>(paragraph) };
+        float lineWidth = 0;
+        bool hasWord = false;
+        std::size_t pos = paragraph;
+        while (pos < paragraphEnd) {
+            if (isSpace(content[pos])) {
+                lineWidth += m_contentSpace;
+                pos++;
+                continue;
+            }
+            auto end = pos;
+            while (end < paragraphEnd && !isSpace(content[end])) {
+                end++;
+            }
+
+            float wordWidth = font.measure(content.substr(pos, end - pos));
+            if (hasWord && lineWidth + wordWidth > maxWidth) {
+                if (full()) {
+                    return maxLines;
+                }
+                m_lines.push_back(line);
+                line.begin = static_cast<std::uint32_t>(pos);
+                lineWidth = 0;
+            }
+            hasWord = true;
+            lineWidth += wordWidth;
+            line.end = static_cast<std::uint32_t>(end);
+            pos = end;
+        }
+        if (full()) {
+            return maxLines;
+        }
+        m_lines.push_back(line);
+
+        if (paragraphEnd == content.size()) {
+            break;
+        }
+        newlines++;
+        paragraph = paragraphEnd + 1;
+    }
+    return static_cast<std::uint32_t>(m_lines.size() - firstLine);
+}
+
+void NewsLayout::joinLines(std::string_view text, std::span<const LayoutLine> lines, std::string& out) {
+    out.clear();
+    for (std::size_t i = 0; i < lines.size(); i++) {
+        if (i > 0) {
+            out += '\n';
+        }
+        for (auto pos = lines[i].begin; pos < lines[i].end; pos++) {
+            out += isSpace(text[pos]) ? ' ' : text[pos];
+        }
+    }
+}
+
+}
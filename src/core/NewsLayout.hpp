@@ -0,0 +1,100 @@
+#pragma once
+
+#include "NewsItemView.hpp"
+#include "TaskPool.hpp"
+#include "TextWrap.hpp"
+#include "VirtualList.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace steamfeed {
+
+// One of the fonts an article is drawn in, in points before the label's own scale
+struct LayoutFont {
+    MeasureWord measure;
+    float lineHeight = 0;
+    float scale = 1; // the label's node scale
+};
+
+struct NewsLayoutStyle {
+    float width = 0;     // of the cell, in points
+    float padding = 40;
+    LayoutFont title;
+    LayoutFont date;
+    LayoutFont content;
+    // content lines laid out for an article until it's expanded, 0 for all of them. Whatever
+    // is past them is never measured, so a preview costs the same for any length of article.
+    std::uint32_t previewLines = 0;
+};
+
+// A line of an article's text as a byte range into the title or content it came from
+struct LayoutLine {
+    std::uint32_t begin = 0;
+    std::uint32_t end = 0;
+};
+
+// Where everything of one article goes, in points from the bottom of its cell
+struct ArticleLayout {
+    float height = 0;
+    float spacing = 0; // to the next article up
+    float titleTop = 0;
+    float dateTop = 0;
+    float contentTop = 0;
+    std::uint32_t firstLine = 0; // the title's lines, then the content's
+    std::uint32_t titleLines = 0;
+    std::uint32_t contentLines = 0;
+    bool truncated = false; // the content goes on past its lines, expand() lays out the rest
+};
+
+// Lays out the whole feed from font metrics alone: line breaks, label positions and cell
+// heights go into flat arrays, so the scroll view knows its full height before a single
+// node exists and cells only have to set the strings they're handed.
+class NewsLayout {
+public:
+    NewsLayout() = default;
+    explicit NewsLayout(NewsLayoutStyle style);
+
+    void clear();
+    // Lays out the next article up. The views only have to live for the call, lines
+    // refer to them by offset.
+    const ArticleLayout& append(std::string_view title, std::string_view content);
+    // Takes over an article another layout of the same style already did, without measuring
+    // it again. The lines stay valid for any copy of the same title and content.
+    const ArticleLayout& append(const NewsLayout& other, std::size_t index);
+    // Lays out all of an article's content, which moves the articles below it down
+    const ArticleLayout& expand(std::size_t index, std::string_view title, std::string_view content);
+    // Lays out items one after another, the same as appending each of them, with the measuring
+    // spread over pool's threads. The style's measure functions get called from all of them.
+    void append(std::span<const NewsItemView> items, TaskPool& pool);
+
+    std::size_t size() const { return m_articles.size(); }
+    const ArticleLayout& operator[](std::size_t index) const { return m_articles[index]; }
+    std::span<const LayoutLine> titleLines(std::size_t index) const;
+    std::span<const LayoutLine> contentLines(std::size_t index) const;
+
+    // Offsets of every article in the scroll view
+    const VirtualList& list() const { return m_list; }
+    float totalHeight() const { return m_list.totalHeight(); }
+
+    // The label string for laid out lines of text: the lines joined by '\n', with any
+    // other whitespace inside a line flattened to spaces
+    static void joinLines(std::string_view text, std::span<const LayoutLine> lines, std::string& out);
+
+private:
+    // Lays out an article onto the end of the lines, up to maxContentLines of its content (0 for all)
+    ArticleLayout layoutArticle(std::string_view title, std::string_view content, std::uint32_t maxContentLines);
+    std::uint32_t wrapTitle(std::string_view title);
+    std::uint32_t wrapContent(std::string_view content, std::uint32_t maxLines, std::size_t& newlines, bool& truncated);
+
+    NewsLayoutStyle m_style;
+    float m_contentSpace = 0;
+    std::vector<ArticleLayout> m_articles;
+    std::vector<LayoutLine> m_lines;
+    VirtualList m_list;
+};
+
+}
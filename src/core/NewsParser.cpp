@@ -0,0 +1,114 @@
+#include "NewsParser.hpp"
+#include "NewsDedup.hpp"
+#include "TextSanitizer.hpp"
+#include <cstring>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
+#include <rapidjson/stream.h>
+
+using namespace rapidjson;
+
+namespace steamfeed {
+
+bool parseRawNewsItems(const char* json, std::size_t length, const GidRuleTable& rules, const NewsItemSink& sink) {
+    MemoryStream stream(json, length);
+    NewsItemHandler handler(sink, rules);
+    Reader reader;
+    return !reader.Parse(stream, handler).IsError();
+}
+
+std::vector<NewsItem> parseRawNewsItems(const std::string& response, const GidRuleTable& rules) {
+    std::vector<NewsItem> newsItems;
+    bool parsed = parseRawNewsItems(response.data(), response.size(), rules, [&](NewsItem&& item) {
+        newsItems.push_back(std::move(item));
+        return true;
+    });
+    // a truncated or malformed response shows nothing rather than half a feed
+    if (!parsed) {
+        newsItems.clear();
+    }
+    return newsItems;
+}
+
+bool parseNewsItems(const char* json, std::size_t length, const GidRuleTable& rules, const NewsItemSink& sink) {
+    NewsDedup dedup;
+    return parseRawNewsItems(json, length, rules, [&](NewsItem&& item) {
+        if (dedup.isDuplicate(item.title, item.content)) {
+            return true;
+        }
+        item.content = removeUnwantedParts(item.content, item.rules);
+        return sink(std::move(item));
+    });
+}
+
+std::vector<NewsItem> parseNewsItems(const std::string& response, const GidRuleTable& rules) {
+    std::vector<NewsItem> newsItems;
+    bool parsed = parseNewsItems(response.data(), response.size(), rules, [&](NewsItem&& item) {
+        newsItems.push_back(std::move(item));
+        return true;
+    });
+    if (!parsed) {
+        newsItems.clear();
+    }
+    return newsItems;
+}
+
+bool ParsedFeed::parse(std::string response, const GidRuleTable& rules, const NewsItemViewSink& sink, ScratchArena* scratch) {
+    std::string sanitized; // reused, only its capacity grows
+    DateFormatter dates;
+    return read(std::move(response), rules, scratch, [&](RawNewsItem& raw) {
+        auto& item = raw.view;
+        removeUnwantedParts(item.content, raw.rules, sanitized);
+        item.content = place(item.content, sanitized);
+        if (raw.hasDate) {
+            auto& date = m_dates.emplace_back();
+            dates.format(item.timestamp, date.data());
+            item.date = date.data();
+        }
+        m_items.push_back(item);
+        return !sink || sink(m_items.back());
+    });
+}
+
+bool ParsedFeed::read(std::string response, const GidRuleTable& rules, ScratchArena* scratch, const RawNewsItemSink& onItem) {
+    m_buffer = std::make_unique<std::string>(std::move(response));
+    m_dates.clear();
+    m_grown.clear();
+    m_items.clear();
+
+    if (scratch) {
+        scratch->reset();
+    }
+    NewsDedup dedup(NewsDedup::DefaultMaxDistance, scratch ? scratch->resource() : std::pmr::get_default_resource());
+    RawNewsItemSink keep = [&](RawNewsItem& raw) {
+        auto& item = raw.view;
+        if (dedup.isDuplicate(item.title, item.content)) {
+            return true;
+        }
+        return onItem(raw);
+    };
+    InSituNewsItemHandler handler(keep, rules);
+
+    InsituStringStream stream(m_buffer->data());
+    Reader reader;
+    bool parsed = !reader.Parse<kParseInsituFlag>(stream, handler).IsError();
+    m_received = handler.received();
+    m_oldestReceived = handler.oldestReceived();
+    return parsed;
+}
+
+std::string_view ParsedFeed::place(std::string_view original, const std::string& sanitized) {
+    if (sanitized.empty()) {
+        return ""; // the original may be the handler's "" for a missing field, not part of the buffer
+    }
+    // sanitizing only takes text out, apart from the rare "/RubRub" replacement
+    if (sanitized.size() > original.size()) {
+        return m_grown.emplace_back(sanitized);
+    }
+    auto at = m_buffer->data() + (original.data() - m_buffer->data());
+    std::memcpy(at, sanitized.data(), sanitized.size());
+    at[sanitized.size()] = '\0';
+    return { at, sanitized.size() };
+}
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "NewsItem.hpp"
+#include "NewsItemHandler.hpp"
+#include "NewsItemView.hpp"
+#include "ScratchArena.hpp"
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace steamfeed {
+
+// Streams the articles out of a GetNewsForApp response in API order (newest first) without
+// building a DOM, dropping the gids the rules skip. The contents are left untouched. Returns
+// false on malformed JSON or when the sink stopped the parse.
+bool parseRawNewsItems(const char* json, std::size_t length, const GidRuleTable& rules, const NewsItemSink& sink);
+std::vector<NewsItem> parseRawNewsItems(const std::string& response, const GidRuleTable& rules);
+
+// Full pipeline used by the layer: parse, drop repeated articles and sanitize the contents.
+// Articles reach the sink in API order, newest first, which is also the order the layer
+// shows them top to bottom, so the first screenful is ready before the rest is parsed.
+bool parseNewsItems(const char* json, std::size_t length, const GidRuleTable& rules, const NewsItemSink& sink);
+std::vector<NewsItem> parseNewsItems(const std::string& response, const GidRuleTable& rules);
+
+// Called with every article of a ParsedFeed as soon as it's ready, return false to stop parsing
+using NewsItemViewSink = std::function<bool(const NewsItemView& item)>;
+
+// A response run through the same pipeline as parseNewsItems, but parsed in place: the feed
+// takes the response over, the reader decodes the strings inside it, and the sanitized
+// contents go back over the text they came from. The articles are views into the buffer,
+// valid for as long as the feed lives, moves included, and the only allocations besides the
+// buffer are a few blocks of dates and the odd content that came out longer than it went in.
+class ParsedFeed {
+public:
+    // Returns false on malformed JSON or when the sink stopped the parse, the articles that
+    // came before are kept either way. Articles already handed out stay untouched while the
+    // parse goes on, so they can be read from another thread in the meantime. With a scratch
+    // arena the parse's working tables come out of it, it gets reset first.
+    bool parse(std::string response, const GidRuleTable& rules, const NewsItemViewSink& sink = {}, ScratchArena* scratch = nullptr);
+
+    const std::vector<NewsItemView>& items() const { return m_items; }
+    std::size_t size() const { return m_items.size(); }
+    bool empty() const { return m_items.empty(); }
+    const NewsItemView& operator[](std::size_t index) const { return m_items[index]; }
+    // Articles in the response, the ones the rules skip and the repeats included, so a page
+    // of the API only comes up short of its count at the end of the feed
+    std::size_t received() const { return m_received; }
+    // The date of the oldest of them, 0 when there were none
+    std::int64_t oldestReceived() const { return m_oldestReceived; }
+
+private:
+    // Takes the response over and reads it in place, handing onItem every article that isn't
+    // a repeat, still raw and without its date
+    bool read(std::string response, const GidRuleTable& rules, ScratchArena* scratch, const RawNewsItemSink& onItem);
+    // Where a sanitized content ends up, over the original when it fits. Touches only the
+    // original's bytes unless the sanitized text is longer.
+    std::string_view place(std::string_view original, const std::string& sanitized);
+
+    std::unique_ptr<std::string> m_buffer; // behind a pointer, so moving the feed can't move the text
+    std::deque<std::array<char, NewsDateSize>> m_dates;
+    std::deque<std::string> m_grown;
+    std::vector<NewsItemView> m_items;
+    std::size_t m_received = 0;
+    std::int64_t m_oldestReceived = 0;
+};
+
+}
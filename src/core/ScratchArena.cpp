@@ -0,0 +1,28 @@
+#include "ScratchArena.hpp"
+
+namespace steamfeed {
+
+ScratchArena::ScratchArena(std::size_t initialSize) : m_block(initialSize) {
+    m_arena.emplace(m_block.data(), m_block.size(), &m_overflow);
+}
+
+void ScratchArena::reset() {
+    m_arena.reset();
+    if (m_overflow.bytes > 0) {
+        // the monotonic resource grows its chunks geometrically, what it took is a fair guess at what's needed
+        m_block.resize(m_block.size() + m_overflow.bytes);
+        m_overflow.bytes = 0;
+    }
+    m_arena.emplace(m_block.data(), m_block.size(), &m_overflow);
+}
+
+void* ScratchArena::Overflow::do_allocate(std::size_t bytes, std::size_t alignment) {
+    this->bytes += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void ScratchArena::Overflow::do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+namespace steamfeed {
+
+// Memory for what a refresh only needs while it runs, like the dedup tables. Everything
+// comes out of one block with a pointer bump, nothing is freed on its own, and reset()
+// hands it all back at once. The block grows to the biggest refresh seen so far, so from
+// the second refresh on the arena doesn't go to the heap at all.
+// One thread at a time, and nothing allocated from it may be used after a reset().
+class ScratchArena {
+public:
+    explicit ScratchArena(std::size_t initialSize = 64 * 1024);
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &*m_arena; }
+    void reset();
+
+    // Bytes the block holds, and how many went past it to the heap since the last reset
+    std::size_t capacity() const { return m_block.size(); }
+    std::size_t overflow() const { return m_overflow.bytes; }
+
+private:
+    // The heap behind the block, counting what it hands out so the next block can be big enough
+    class Overflow : public std::pmr::memory_resource {
+    public:
+        std::size_t bytes = 0;
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    std::vector<std::byte> m_block;
+    Overflow m_overflow;
+    std::optional<std::pmr::monotonic_buffer_resource> m_arena;
+};
+
+}
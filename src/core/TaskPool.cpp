@@ -0,0 +1,120 @@
+#include "TaskPool.hpp"
+#include <algorithm>
+
+namespace steamfeed {
+
+TaskPool::TaskPool(unsigned threads) {
+    threads = std::max(threads, 1u);
+    for (unsigned i = 0; i < threads; i++) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 1; i < threads; i++) {
+        m_threads.emplace_back([this, i] { run(i); });
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+unsigned TaskPool::defaultThreads() {
+    auto hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? hardware - 1 : 1;
+}
+
+void TaskPool::parallelFor(std::size_t count, std::size_t grain, const Chunk& chunk) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+    std::size_t chunks = (count + grain - 1) / grain;
+    if (chunks == 1 || m_threads.empty()) {
+        for (std::size_t begin = 0; begin < count; begin += grain) {
+            chunk(begin, std::min(begin + grain, count));
+        }
+        return;
+    }
+
+    Job job;
+    job.chunk = &chunk;
+    job.remaining = chunks;
+    // neighbouring chunks go to the same queue, each thread starts on a run of its own
+    for (std::size_t i = 0; i < chunks; i++) {
+        auto& queue = *m_queues[i * m_queues.size() / chunks];
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back({ &job, i * grain, std::min((i + 1) * grain, count) });
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        m_queued += chunks;
+    }
+    m_wake.notify_all();
+
+    Task task;
+    while (job.remaining > 0 && take(0, task)) {
+        execute(task);
+    }
+    // the last chunks are running elsewhere
+    std::unique_lock lock(job.mutex);
+    job.done.wait(lock, [&] { return job.remaining == 0; });
+}
+
+void TaskPool::run(std::size_t index) {
+    Task task;
+    while (true) {
+        if (take(index, task)) {
+            execute(task);
+            continue;
+        }
+        std::unique_lock lock(m_mutex);
+        m_wake.wait(lock, [this] { return m_stopping || m_queued > 0; });
+        if (m_stopping) {
+            return;
+        }
+    }
+}
+
+bool TaskPool::take(std::size_t index, Task& task) {
+    bool found = false;
+    {
+        auto& own = *m_queues[index];
+        std::lock_guard lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            found = true;
+        }
+    }
+    for (std::size_t i = 1; !found && i < m_queues.size(); i++) {
+        auto& other = *m_queues[(index + i) % m_queues.size()];
+        std::lock_guard lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = other.tasks.front();
+            other.tasks.pop_front();
+            found = true;
+        }
+    }
+    if (found) {
+        std::lock_guard lock(m_mutex);
+        m_queued--;
+    }
+    return found;
+}
+
+void TaskPool::execute(const Task& task) {
+    (*task.job->chunk)(task.begin, task.end);
+    // the job lives on the caller's stack, it may be gone the moment the count reaches zero
+    std::lock_guard lock(task.job->mutex);
+    if (--task.job->remaining == 0) {
+        task.job->done.notify_all();
+    }
+}
+
+}
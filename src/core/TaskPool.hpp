@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace steamfeed {
+
+// A few threads for splitting one job's independent items, like sanitizing and laying out
+// parsed articles. parallelFor cuts a range into chunks and deals them out to every
+// thread's own queue. A thread takes from the back of its own queue and, once that's empty,
+// steals from the front of the others', so an uneven chunk doesn't leave the rest idle.
+// The calling thread works along and only returns once every chunk is done.
+class TaskPool {
+public:
+    // Runs the chunk [begin, end), from whichever thread picked it up
+    using Chunk = std::function<void(std::size_t begin, std::size_t end)>;
+
+    // threads counts the caller, so 1 is no extra threads and everything runs inline
+    explicit TaskPool(unsigned threads = defaultThreads());
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    unsigned threads() const { return static_cast<unsigned>(m_queues.size()); }
+
+    // Runs chunk over [0, count) in pieces of grain items, the last one shorter, so a chunk's
+    // index is begin / grain. Chunks run in any order and on any thread.
+    void parallelFor(std::size_t count, std::size_t grain, const Chunk& chunk);
+
+    // One less than the hardware threads, leaving the game's main thread its own
+    static unsigned defaultThreads();
+
+private:
+    struct Job {
+        const Chunk* chunk;
+        std::atomic<std::size_t> remaining;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    struct Task {
+        Job* job;
+        std::size_t begin;
+        std::size_t end;
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(std::size_t index);
+    // Off the back of queue index, or stolen from the front of another
+    bool take(std::size_t index, Task& task);
+    void execute(const Task& task);
+
+    std::vector<std::unique_ptr<Queue>> m_queues; // the caller's first, then one per thread
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::size_t m_queued = 0; // tasks sitting in any queue, under m_mutex
+    bool m_stopping = false;
+    std::vector<std::thread> m_threads;
+};
+
+}
@@ -0,0 +1,231 @@
+#include "TextSanitizer.hpp"
+#include "GidRules.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace steamfeed {
+
+namespace {
+    // Streaming form of "while (find(marker)) erase from the marker through the next space",
+    // where a marker that shows up without a space after it takes the rest of the text.
+    // Characters that may still become part of a marker, including one that only forms once
+    // an erase joins the text around it, are held back. Everything else goes straight on.
+    // Relies on the marker's first character not appearing anywhere else in it.
+    template <const std::string_view& Marker, class Next>
+    class MarkerEraser {
+    public:
+        explicit MarkerEraser(Next& next) : m_next(next) {}
+
+        void push(char c) {
+            if (m_skipping) {
+                m_skipping = c != ' ';
+                return;
+            }
+
+            if (c == Marker[0]) {
+                m_start = m_pending.size();
+                m_pending += c;
+                return;
+            }
+            if (m_pending.empty()) {
+                m_next.push(c);
+                return;
+            }
+
+            auto matched = m_pending.size() - m_start;
+            if (Marker[matched] != c) {
+                // no marker can run through the held back text anymore
+                flush();
+                m_next.push(c);
+                return;
+            }
+
+            m_pending += c;
+            if (matched + 1 == Marker.size()) {
+                // resuming whatever partial marker was in front of this one
+                m_pending.resize(m_start);
+                m_start = m_pending.rfind(Marker[0]);
+                m_skipping = true;
+            }
+        }
+
+        void finish() {
+            flush();
+            m_next.finish();
+        }
+
+        // nothing held back or being skipped anywhere down the chain
+        bool idle() const {
+            return !m_skipping && m_pending.empty() && m_next.idle();
+        }
+
+    private:
+        void flush() {
+            for (char c : m_pending) {
+                m_next.push(c);
+            }
+            m_pending.clear();
+        }
+
+        Next& m_next;
+        std::string m_pending;
+        std::size_t m_start = 0;
+        bool m_skipping = false;
+    };
+
+    constexpr std::string_view s_video = "previewyoutube=";
+    constexpr std::string_view s_url = "url=";
+    constexpr std::string_view s_closingUrl = "/url";
+
+    enum CharClass : unsigned char { Plain, Bracket, Space, Special };
+
+    // Plain characters can be copied straight into a word, Special ones still have to go
+    // through the erasers and the "/list" check
+    constexpr auto s_charClasses = [] {
+        std::array<CharClass, 256> classes = {};
+        for (char c : { s_video[0], s_url[0], s_closingUrl[0], 't' }) {
+            classes[static_cast<unsigned char>(c)] = Special;
+        }
+        classes['['] = classes[']'] = Bracket;
+        for (unsigned char c : { ' ', '\n', '\t', '\r', '\v', '\f' }) {
+            classes[c] = Space;
+        }
+        return classes;
+    }();
+
+    // The tail of the pipeline: drops the brackets and "/list", optionally every '/', replaces
+    // words containing "/Ru" with "/RubRub" and joins the words with single spaces. Writes
+    // through a raw pointer into out, which is sized up front: everything but the "/RubRub"
+    // replacements is at most as long as the text it came from.
+    class WordWriter {
+    public:
+        WordWriter(std::string& out, std::size_t inputSize, bool stripSlashes) : m_out(out), m_stripSlashes(stripSlashes) {
+            m_out.resize(inputSize + ReplacementSize);
+            m_data = m_out.data();
+        }
+
+        void push(char c) {
+            switch (s_charClasses[static_cast<unsigned char>(c)]) {
+                case Bracket: return;
+                case Space: endWord(); return;
+                default: break;
+            }
+
+            if (!m_inWord) {
+                if (m_size > 0) {
+                    m_data[m_size++] = ' ';
+                }
+                m_wordStart = m_size;
+                m_inWord = true;
+            }
+            m_data[m_size++] = c;
+
+            // "/list" never spans whitespace, so it can only sit at the end of the current word
+            if (c == 't' && m_size - m_wordStart >= 5 && std::memcmp(m_data + m_size - 5, "/list", 5) == 0) {
+                m_size -= 5;
+                dropIfEmpty();
+            }
+        }
+
+        // Copies the run of plain characters at the front of [it, end) into the current word
+        const char* appendPlain(const char* it, const char* end) {
+            if (!m_inWord) {
+                return it;
+            }
+            auto size = m_size;
+            while (it != end && s_charClasses[static_cast<unsigned char>(*it)] == Plain) {
+                m_data[size++] = *it++;
+            }
+            m_size = size;
+            return it;
+        }
+
+        void finish() {
+            endWord();
+            m_out.resize(m_size);
+        }
+
+        bool idle() const {
+            return true;
+        }
+
+    private:
+        static constexpr std::string_view Replacement = "/RubRub";
+        static constexpr std::size_t ReplacementSize = 7;
+
+        void endWord() {
+            if (!m_inWord) {
+                return;
+            }
+
+            if (m_stripSlashes) {
+                auto end = std::remove(m_data + m_wordStart, m_data + m_size, '/');
+                m_size = static_cast<std::size_t>(end - m_data);
+                if (dropIfEmpty()) {
+                    return;
+                }
+            }
+
+            std::string_view word(m_data + m_wordStart, m_size - m_wordStart);
+            if (word.find("/Ru") != std::string_view::npos) {
+                // a word of three characters may grow to seven, the buffer always has room for one more
+                m_size = m_wordStart;
+                std::memcpy(m_data + m_size, Replacement.data(), ReplacementSize);
+                m_size += ReplacementSize;
+                m_out.resize(m_out.size() + ReplacementSize);
+                m_data = m_out.data();
+            }
+            m_inWord = false;
+        }
+
+        // takes the separator back out when everything in the word got removed
+        bool dropIfEmpty() {
+            if (m_size != m_wordStart) {
+                return false;
+            }
+            if (m_wordStart > 0) {
+                m_size--;
+            }
+            m_inWord = false;
+            return true;
+        }
+
+        std::string& m_out;
+        char* m_data;
+        std::size_t m_size = 0;
+        bool m_stripSlashes;
+        bool m_inWord = false;
+        std::size_t m_wordStart = 0;
+    };
+}
+
+void removeUnwantedParts(std::string_view text, std::uint8_t rules, std::string& out) {
+    WordWriter words(out, text.size(), rules & StripSlashes);
+
+    // The removed portions of text, in the order the markers used to be erased in
+    MarkerEraser<s_closingUrl, WordWriter> closingUrls(words);
+    MarkerEraser<s_url, decltype(closingUrls)> urls(closingUrls);
+    MarkerEraser<s_video, decltype(urls)> videos(urls);
+
+    auto it = text.data();
+    auto end = it + text.size();
+    while (it != end) {
+        if (videos.idle()) {
+            it = words.appendPlain(it, end);
+            if (it == end) {
+                break;
+            }
+        }
+        videos.push(*it++);
+    }
+    videos.finish();
+}
+
+std::string removeUnwantedParts(const std::string& text, std::uint8_t rules) {
+    std::string result;
+    removeUnwantedParts(text, rules, result);
+    return result;
+}
+
+}
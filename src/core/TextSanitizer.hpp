@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace steamfeed {
+
+// Strips Steam's BBCode markup down to the plain text shown in the feed, in a single pass
+// over the text, applying the article's GidRule bits. Writes into out (cleared first), so a
+// buffer can be reused across articles.
+void removeUnwantedParts(std::string_view text, std::uint8_t rules, std::string& out);
+std::string removeUnwantedParts(const std::string& text, std::uint8_t rules);
+
+}
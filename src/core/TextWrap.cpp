@@ -0,0 +1,44 @@
+#include "TextWrap.hpp"
+
+namespace steamfeed {
+
+namespace {
+    bool isSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+}
+
+std::string wrapText(std::string_view text, float maxWidth, const MeasureWord& measure) {
+    std::string wrappedText;
+    wrappedText.reserve(text.size() + 8);
+    float lineWidth = 0;
+    float buffer = -100;  // Setting the buffer for longer lines before wrapping happens.
+
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        if (isSpace(text[pos])) {
+            pos++;
+            continue;
+        }
+        auto end = pos;
+        while (end < text.size() && !isSpace(text[end])) {
+            end++;
+        }
+        auto word = text.substr(pos, end - pos);
+        pos = end;
+
+        float wordWidth = measure(word);
+        if (lineWidth + wordWidth + buffer > maxWidth) {
+            wrappedText += '\n';
+            lineWidth = 0;
+        }
+
+        wrappedText += word;
+        wrappedText += ' ';
+        lineWidth += wordWidth;
+    }
+
+    return wrappedText;
+}
+
+}
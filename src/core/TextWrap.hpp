@@ -0,0 +1,16 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace steamfeed {
+
+// Returns the rendered width of a single word in the target font
+using MeasureWord = std::function<float(std::string_view word)>;
+
+// Greedy word wrap, inserting '\n' once a line would overflow maxWidth. Every word is
+// followed by a space, same as the labels have always been built.
+std::string wrapText(std::string_view text, float maxWidth, const MeasureWord& measure);
+
+}
@@ -0,0 +1,42 @@
+#include "VirtualList.hpp"
+#include <algorithm>
+
+namespace steamfeed {
+
+void VirtualList::clear() {
+    m_offsets.clear();
+    m_heights.clear();
+    m_ends.clear();
+    m_totalHeight = 0;
+}
+
+void VirtualList::append(float height, float spacing) {
+    m_offsets.push_back(m_totalHeight);
+    m_heights.push_back(height);
+    m_ends.push_back(m_totalHeight + height);
+    m_totalHeight += height + spacing;
+}
+
+void VirtualList::resize(std::size_t index, float height, float spacing) {
+    float next = index + 1 < m_offsets.size() ? m_offsets[index + 1] : m_totalHeight;
+    float delta = m_offsets[index] + height + spacing - next;
+    m_heights[index] = height;
+    m_ends[index] = m_offsets[index] + height;
+    for (auto i = index + 1; i < m_offsets.size(); i++) {
+        m_offsets[i] += delta;
+        m_ends[i] += delta;
+    }
+    m_totalHeight += delta;
+}
+
+VirtualList::Range VirtualList::visibleRange(float from, float to, float margin) const {
+    // first item still reaching past the upper edge, first one starting below the lower edge
+    auto first = std::upper_bound(m_ends.begin(), m_ends.end(), from - margin) - m_ends.begin();
+    auto last = std::upper_bound(m_offsets.begin(), m_offsets.end(), to + margin) - m_offsets.begin();
+    Range range;
+    range.first = static_cast<std::size_t>(first);
+    range.last = std::max(range.first, static_cast<std::size_t>(last));
+    return range;
+}
+
+}
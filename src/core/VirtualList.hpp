@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace steamfeed {
+
+// Vertical positions of a list laid out top-down (item 0 at the top, offsets measured down
+// from there), so a scroll view only has to build the items inside its window and items
+// appended later only add to the bottom. Offsets only ever grow, which keeps finding the
+// window a binary search, and a resized item only moves the ones below it.
+class VirtualList {
+public:
+    // [first, last) item indices
+    struct Range {
+        std::size_t first = 0;
+        std::size_t last = 0;
+        bool contains(std::size_t index) const { return index >= first && index < last; }
+        std::size_t size() const { return last - first; }
+    };
+
+    void clear();
+    // Adds an item of the given height at the bottom, with spacing before the next one
+    void append(float height, float spacing);
+    // Gives an item a new height and spacing, moving everything below it
+    void resize(std::size_t index, float height, float spacing);
+
+    std::size_t size() const { return m_offsets.size(); }
+    float offset(std::size_t index) const { return m_offsets[index]; }
+    float height(std::size_t index) const { return m_heights[index]; }
+    float totalHeight() const { return m_totalHeight; }
+
+    // The items overlapping [from - margin, to + margin], both measured down from the top
+    Range visibleRange(float from, float to, float margin) const;
+
+private:
+    std::vector<float> m_offsets;
+    std::vector<float> m_heights;
+    std::vector<float> m_ends; // offset + height, ascending as well
+    float m_totalHeight = 0;
+};
+
+}
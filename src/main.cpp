@@ -1,9 +1,15 @@
 #include <Geode/Geode.hpp>
 #include <Geode/modify/MenuLayer.hpp>
+#include "NewsFeed.hpp"
 #include "SteamNewsLayer.hpp"
 
 using namespace geode::prelude;
 
+namespace {
+    // long enough for the menu to finish loading its sprites and settle into its frame rate
+    constexpr float PrefetchDelay = 2.0f;
+}
+
 class $modify(MyMenuLayer, MenuLayer) {
     bool init() {
         if (!MenuLayer::init()) return false;
@@ -26,6 +32,15 @@ class $modify(MyMenuLayer, MenuLayer) {
             geode::log::error("Steam Feed: Bottom menu not found");
         }
 
+        // opt in, the feed loads in the background so the popup opens with it ready
+        if (Mod::get()->getSettingValue<bool>("prefetch-feed")) {
+            this->scheduleOnce(schedule_selector(MyMenuLayer::prefetchFeed), PrefetchDelay);
+        }
+
         return true;
     }
+
+    void prefetchFeed(float dt) {
+        NewsFeed::get().prefetch();
+    }
 };